@@ -0,0 +1,295 @@
+// atlas-packer
+// Pakuje sprajtove u jedan atlas za roller-coaster. Pokrece se posle svog
+// build-a (PostBuildEvent) nad res/ i pravi <izlaz>.tga i <izlaz>.txt.
+//
+//   atlas-packer [-m mip_nivoi] [-x max_stranica] -o res/atlas slika1.png slika2.png ...
+//
+// Tabela: prvi red je "<slika> sirina visina mip_nivoi", zatim po sprajtu
+// "ime x y sirina visina" u pikselima atlasa, (0, 0) je gore levo, bez
+// ivice. Ime je ime fajla bez putanje i ekstenzije.
+
+#define _CRT_SECURE_NO_WARNINGS
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Sprite {
+    std::string name;
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels; // RGBA, gore levo prvi
+    int input = 0;                      // redni broj na komandnoj liniji
+    int x = 0, y = 0;                   // polozaj u atlasu, bez ivice
+};
+
+struct Rect {
+    int x, y, width, height;
+};
+
+// MaxRects
+// Slobodan prostor je lista pravougaonika koji se mogu preklapati. Sprajt ide
+// u slobodan pravougaonik sa najmanjim kracim ostatkom (best short side fit),
+// a svaki slobodan pravougaonik koji preseca deli se na do cetiri manja.
+class MaxRects {
+public:
+    MaxRects(int width, int height) { freeRects.push_back({ 0, 0, width, height }); }
+
+    bool insert(int width, int height, Rect& placed)
+    {
+        int bestShort = -1, bestLong = 0;
+        for (const Rect& free : freeRects) {
+            if (free.width < width || free.height < height) continue;
+            int leftX = free.width - width;
+            int leftY = free.height - height;
+            int shortSide = std::min(leftX, leftY);
+            int longSide = std::max(leftX, leftY);
+            if (bestShort < 0 || shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+                placed = { free.x, free.y, width, height };
+                bestShort = shortSide;
+                bestLong = longSide;
+            }
+        }
+        if (bestShort < 0) return false;
+
+        std::vector<Rect> next;
+        for (const Rect& free : freeRects) split(free, placed, next);
+        freeRects.swap(next);
+        prune();
+        return true;
+    }
+
+private:
+    static bool intersects(const Rect& a, const Rect& b)
+    {
+        return a.x < b.x + b.width && b.x < a.x + a.width &&
+            a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+
+    static bool contains(const Rect& outer, const Rect& inner)
+    {
+        return inner.x >= outer.x && inner.y >= outer.y &&
+            inner.x + inner.width <= outer.x + outer.width &&
+            inner.y + inner.height <= outer.y + outer.height;
+    }
+
+    static void split(const Rect& free, const Rect& used, std::vector<Rect>& out)
+    {
+        if (!intersects(free, used)) {
+            out.push_back(free);
+            return;
+        }
+        if (used.x > free.x)
+            out.push_back({ free.x, free.y, used.x - free.x, free.height });
+        if (used.x + used.width < free.x + free.width)
+            out.push_back({ used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height });
+        if (used.y > free.y)
+            out.push_back({ free.x, free.y, free.width, used.y - free.y });
+        if (used.y + used.height < free.y + free.height)
+            out.push_back({ free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height });
+    }
+
+    // izbacuje slobodne pravougaonike sadrzane u drugima
+    void prune()
+    {
+        for (size_t i = 0; i < freeRects.size(); ++i) {
+            for (size_t j = i + 1; j < freeRects.size(); ++j) {
+                if (contains(freeRects[j], freeRects[i])) {
+                    freeRects.erase(freeRects.begin() + i);
+                    --i;
+                    break;
+                }
+                if (contains(freeRects[i], freeRects[j])) {
+                    freeRects.erase(freeRects.begin() + j);
+                    --j;
+                }
+            }
+        }
+    }
+
+    std::vector<Rect> freeRects;
+};
+
+static int roundUp(int v, int align)
+{
+    return (v + align - 1) / align * align;
+}
+
+static std::string spriteName(const std::string& path)
+{
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.find_last_of('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+// sprajtovi se pakuju u blokovima od block piksela, sa ivicom od jednog bloka,
+// pa do mip nivoa log2(block) nijedan teksel ne mesa dva sprajta
+static bool pack(std::vector<Sprite>& sprites, int width, int height, int block)
+{
+    MaxRects bins(width / block, height / block);
+    for (Sprite& sprite : sprites) {
+        int blocksX = roundUp(sprite.width, block) / block + 2;
+        int blocksY = roundUp(sprite.height, block) / block + 2;
+        Rect placed = {};
+        if (!bins.insert(blocksX, blocksY, placed)) return false;
+        sprite.x = (placed.x + 1) * block;
+        sprite.y = (placed.y + 1) * block;
+    }
+    return true;
+}
+
+// sprajt i njegova ivica: pikseli van sprajta ponavljaju najblizi ivicni
+static void blit(const Sprite& sprite, int border, std::vector<unsigned char>& atlas, int atlasWidth)
+{
+    for (int y = -border; y < sprite.height + border; ++y) {
+        int sy = std::max(0, std::min(y, sprite.height - 1));
+        for (int x = -border; x < sprite.width + border; ++x) {
+            int sx = std::max(0, std::min(x, sprite.width - 1));
+            const unsigned char* src = &sprite.pixels[(sy * sprite.width + sx) * 4];
+            unsigned char* dst = &atlas[((sprite.y + y) * atlasWidth + sprite.x + x) * 4];
+            std::memcpy(dst, src, 4);
+        }
+    }
+}
+
+// TGA sa RLE kompresijom (tip 10), 32 bita, prvi red je gornji
+static bool writeTga(const std::string& path, const std::vector<unsigned char>& rgba, int width, int height)
+{
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    unsigned char header[18] = {};
+    header[2] = 10;
+    header[12] = width & 0xFF;
+    header[13] = (width >> 8) & 0xFF;
+    header[14] = height & 0xFF;
+    header[15] = (height >> 8) & 0xFF;
+    header[16] = 32;
+    header[17] = 0x20 | 8; // gore levo, 8 bita alfe
+    std::fwrite(header, 1, sizeof(header), file);
+
+    std::vector<unsigned char> out;
+    for (int y = 0; y < height; ++y) {
+        const unsigned char* row = &rgba[y * width * 4];
+        int x = 0;
+        while (x < width) {
+            // ponovljeni piksel: paket do 128 istih
+            int run = 1;
+            while (x + run < width && run < 128 &&
+                std::memcmp(row + x * 4, row + (x + run) * 4, 4) == 0) ++run;
+            if (run > 1) {
+                const unsigned char* p = row + x * 4;
+                out.push_back(static_cast<unsigned char>(0x80 | (run - 1)));
+                out.push_back(p[2]); out.push_back(p[1]); out.push_back(p[0]); out.push_back(p[3]);
+                x += run;
+                continue;
+            }
+            // razliciti pikseli do sledeceg ponavljanja
+            int raw = 1;
+            while (x + raw < width && raw < 128 &&
+                (x + raw + 1 >= width || std::memcmp(row + (x + raw) * 4, row + (x + raw + 1) * 4, 4) != 0)) ++raw;
+            out.push_back(static_cast<unsigned char>(raw - 1));
+            for (int i = 0; i < raw; ++i) {
+                const unsigned char* p = row + (x + i) * 4;
+                out.push_back(p[2]); out.push_back(p[1]); out.push_back(p[0]); out.push_back(p[3]);
+            }
+            x += raw;
+        }
+    }
+    std::fwrite(out.data(), 1, out.size(), file);
+    std::fclose(file);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    int mipLevels = 4;
+    int maxSide = 4096;
+    std::string output;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-m") == 0 && i + 1 < argc) mipLevels = std::max(0, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-x") == 0 && i + 1 < argc) maxSide = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) output = argv[++i];
+        else inputs.push_back(argv[i]);
+    }
+    if (output.empty() || inputs.empty()) {
+        std::cout << "Upotreba: atlas-packer [-m mip_nivoi] [-x max_stranica] -o izlaz slika1.png ..." << std::endl;
+        return 1;
+    }
+
+    std::vector<Sprite> sprites;
+    long long area = 0;
+    const int block = 1 << mipLevels;
+    for (const std::string& path : inputs) {
+        int width, height, channels;
+        unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 4);
+        if (!data) {
+            std::cout << "Slika nije ucitana: " << path << std::endl;
+            return 1;
+        }
+        Sprite sprite;
+        sprite.name = spriteName(path);
+        sprite.input = static_cast<int>(sprites.size());
+        sprite.width = width;
+        sprite.height = height;
+        sprite.pixels.assign(data, data + width * height * 4);
+        stbi_image_free(data);
+
+        area += static_cast<long long>(roundUp(width, block) + 2 * block) * (roundUp(height, block) + 2 * block);
+        sprites.push_back(std::move(sprite));
+    }
+
+    // veci sprajtovi prvi
+    std::stable_sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b) {
+        return std::max(a.width, a.height) > std::max(b.width, b.height);
+    });
+
+    // najmanja stranica stepena dvojke koja moze da primi povrsinu, pa raste
+    int width = block, height = block;
+    while (static_cast<long long>(width) * height < area) {
+        if (width <= height) width *= 2;
+        else height *= 2;
+    }
+    while (!pack(sprites, width, height, block)) {
+        if (width <= height) width *= 2;
+        else height *= 2;
+        if (width > maxSide || height > maxSide) {
+            std::cout << "Sprajtovi ne staju u " << maxSide << " x " << maxSide << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<unsigned char> atlas(width * height * 4, 0);
+    for (const Sprite& sprite : sprites) blit(sprite, block, atlas, width);
+
+    std::string imagePath = output + ".tga";
+    if (!writeTga(imagePath, atlas, width, height)) {
+        std::cout << "Nemoguce upisati " << imagePath << std::endl;
+        return 1;
+    }
+
+    // tabela je u redosledu ulaza
+    std::sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b) {
+        return a.input < b.input;
+    });
+    std::ofstream table(output + ".txt");
+    table << spriteName(imagePath) << ".tga " << width << " " << height << " " << mipLevels << "\n";
+    for (const Sprite& sprite : sprites) {
+        table << sprite.name << " " << sprite.x << " " << sprite.y << " "
+            << sprite.width << " " << sprite.height << "\n";
+    }
+
+    std::cout << "Atlas " << width << " x " << height << ", " << sprites.size()
+        << " sprajtova, upisan u " << imagePath << std::endl;
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "Atlas.h"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include "stb_image.h"
+
+bool loadAtlas(const char* tablePath, TextureAtlas& atlas)
+{
+    std::ifstream table(tablePath);
+    if (!table.is_open()) {
+        std::cout << "Atlas nije pronadjen: " << tablePath << std::endl;
+        return false;
+    }
+
+    // slika je pored tabele
+    std::string imageName;
+    int atlasWidth = 0, atlasHeight = 0, mipLevels = 0;
+    table >> imageName >> atlasWidth >> atlasHeight >> mipLevels;
+
+    std::string folder = tablePath;
+    size_t slash = folder.find_last_of("/\\");
+    folder = slash == std::string::npos ? std::string() : folder.substr(0, slash + 1);
+    std::string imagePath = folder + imageName;
+
+    int width, height, channels;
+    unsigned char* pixels = stbi_load(imagePath.c_str(), &width, &height, &channels, 4);
+    if (!pixels || width != atlasWidth || height != atlasHeight) {
+        std::cout << "Slika atlasa nije ucitana: " << imagePath << std::endl;
+        stbi_image_free(pixels);
+        return false;
+    }
+    // tabela broji redove odozgo, tekstura odozdo
+    for (int row = 0; row < height / 2; ++row) {
+        unsigned char* top = pixels + row * width * 4;
+        unsigned char* bottom = pixels + (height - 1 - row) * width * 4;
+        std::swap_ranges(top, top + width * 4, bottom);
+    }
+
+    std::string name;
+    int x, y, w, h;
+    while (table >> name >> x >> y >> w >> h) {
+        AtlasRect rect;
+        rect.u0 = static_cast<float>(x) / width;
+        rect.u1 = static_cast<float>(x + w) / width;
+        rect.v0 = static_cast<float>(height - y - h) / height;
+        rect.v1 = static_cast<float>(height - y) / height;
+        atlas.names.push_back(name);
+        atlas.rects.push_back(rect);
+    }
+
+    glGenTextures(1, &atlas.texture);
+    glBindTexture(GL_TEXTURE_2D, atlas.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    stbi_image_free(pixels);
+
+    // ivice izmedju sprajtova vaze samo do mip nivoa iz pakera
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipLevels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+int findAtlasRect(const TextureAtlas& atlas, const char* name)
+{
+    for (size_t i = 0; i < atlas.names.size(); ++i) {
+        if (atlas.names[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+void mapQuadToAtlas(std::vector<Vertex>& vertices, int first, int count, const AtlasRect& rect)
+{
+    for (int i = first; i < first + count; ++i) {
+        Vertex& v = vertices[i];
+        v.u = rect.u0 + v.u * (rect.u1 - rect.u0);
+        v.v = rect.v0 + v.v * (rect.v1 - rect.v0);
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Ride.h"
+
+#include <string>
+#include <vector>
+
+// AtlasRect
+// Polozaj sprajta u atlasu u tekstur koordinatama, (u0, v0) je dole levo.
+struct AtlasRect {
+    float u0, v0;
+    float u1, v1;
+};
+
+// TextureAtlas
+// Atlas koji pravi atlas-packer: jedna tekstura i tabela sprajtova po imenu.
+struct TextureAtlas {
+    unsigned texture = 0;
+    std::vector<std::string> names;
+    std::vector<AtlasRect> rects;
+};
+
+// ucitava tabelu i sliku atlasa, false ako neki od fajlova nedostaje
+bool loadAtlas(const char* tablePath, TextureAtlas& atlas);
+
+// indeks sprajta u atlas.rects, -1 ako ga nema
+int findAtlasRect(const TextureAtlas& atlas, const char* name);
+
+// prepisuje tekstur koordinate count verteksa od first iz [0, 1] u rect
+void mapQuadToAtlas(std::vector<Vertex>& vertices, int first, int count, const AtlasRect& rect);
@@ -0,0 +1,224 @@
+#include "FleetSim.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+FleetTrain initialFleetTrain(const FleetTrack& track, int k, int trainCount)
+{
+    float range = track.trackTotalLength - track.train.startSHead;
+    float sHead = track.train.startSHead + range * static_cast<float>(k) / static_cast<float>(trainCount);
+    return { sHead, MIN_SPEED, FLEET_RUNNING, 0 };
+}
+
+// putnik na prvo sediste, vezuje se i voz polazi
+static void boardAndDispatch(RideState& ride, float trackTotalLength)
+{
+    fireRideEvent(ride, RideEvent::AddPassenger, trackTotalLength);
+    fireRideEvent(ride, RideEvent::Buckle, trackTotalLength, 0);
+    fireRideEvent(ride, RideEvent::Dispatch, trackTotalLength);
+}
+
+void FleetSimCpu::init(const FleetTrack& fleetTrack, int trainCount)
+{
+    track = fleetTrack;
+    rides.assign(trainCount, RideState(track.train));
+    for (int k = 0; k < trainCount; ++k) {
+        RideState& ride = rides[k];
+        boardAndDispatch(ride, track.trackTotalLength);
+
+        FleetTrain start = initialFleetTrain(track, k, trainCount);
+        ride.sHead = start.sHead;
+        ride.currentSpeed = start.speed;
+        seekTrackCursor(ride.cursor, ride.sHead, *track.trackS, *track.trackRuns);
+    }
+}
+
+void FleetSimCpu::step()
+{
+    const int trainCount = static_cast<int>(rides.size());
+    for (int k = 0; k < trainCount; ++k) {
+        RideState& ride = rides[k];
+        RidePhase before = ride.phase;
+        updateState(FLEET_STEP, ride, *track.trackS, track.trackTotalLength, *track.vertices, *track.trackRuns,
+            noTrajectory, timers, k);
+
+        if (before == RidePhase::Running && ride.phase == RidePhase::WaitingBeforeReturn) ++rideCount;
+        if (ride.phase == RidePhase::Disembarking) {
+            fireRideEvent(ride, RideEvent::PassengerOff, track.trackTotalLength, 0);
+            boardAndDispatch(ride, track.trackTotalLength);
+        }
+    }
+
+    expired.clear();
+    timers.advance(FLEET_STEP, expired);
+    for (const TimerExpiry& e : expired) onRideTimer(rides[e.owner], e.kind, track.trackTotalLength);
+}
+
+FleetTrain FleetSimCpu::train(int k) const
+{
+    const RideState& ride = rides[k];
+    GLuint phase = FLEET_RUNNING;
+    if (ride.phase == RidePhase::WaitingBeforeReturn) phase = FLEET_WAITING;
+    if (ride.phase == RidePhase::Returning) phase = FLEET_RETURNING;
+    // tik isteka cuva TimerWheel, ovde se ne poredi
+    return { ride.sHead, ride.currentSpeed, phase, 0 };
+}
+
+FleetStats FleetSimCpu::stats() const
+{
+    FleetStats stats = {};
+    stats.rides = rideCount;
+    double sumS = 0.0, sumSpeed = 0.0;
+    for (int k = 0; k < static_cast<int>(rides.size()); ++k) {
+        FleetTrain t = train(k);
+        stats.phaseCount[t.phase]++;
+        sumS += t.sHead;
+        sumSpeed += t.speed;
+        stats.maxSpeed = std::max(stats.maxSpeed, t.speed);
+    }
+    stats.sumS = static_cast<float>(sumS);
+    stats.sumSpeed = static_cast<float>(sumSpeed);
+    return stats;
+}
+
+static bool linked(GLuint program)
+{
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    return success == GL_TRUE;
+}
+
+bool FleetSimGpu::init(const FleetTrack& fleetTrack, int count, const char* stepPath, const char* statsPath)
+{
+    trainCount = count;
+    groupCount = (trainCount + FLEET_GROUP_SIZE - 1) / FLEET_GROUP_SIZE;
+
+    GLint maxGroups = 0;
+    glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, 0, &maxGroups);
+    if (groupCount > maxGroups) {
+        std::cout << "Flota od " << trainCount << " vozova trazi " << groupCount
+            << " radnih grupa, najvise " << maxGroups << "." << std::endl;
+        return false;
+    }
+
+    stepProgram = createComputeShader(stepPath);
+    statsProgram = createComputeShader(statsPath);
+    if (!linked(stepProgram) || !linked(statsProgram)) return false;
+    statsStageLocation = glGetUniformLocation(statsProgram, "uStage");
+    statsCountLocation = glGetUniformLocation(statsProgram, "uCount");
+
+    const std::vector<float>& trackS = *fleetTrack.trackS;
+    const std::vector<TrackRun>& trackRuns = *fleetTrack.trackRuns;
+    const int pointCount = static_cast<int>(trackS.size());
+
+    std::vector<FleetTrain> trains(trainCount);
+    for (int k = 0; k < trainCount; ++k) trains[k] = initialFleetTrain(fleetTrack, k, trainCount);
+
+    // polozaji kao float, isti kao u vertices, da nagib bude isti kao na CPU
+    std::vector<GLfloat> points(pointCount * 2);
+    for (int i = 0; i < pointCount; ++i) {
+        points[i * 2] = (*fleetTrack.vertices)[i].x;
+        points[i * 2 + 1] = (*fleetTrack.vertices)[i].y;
+    }
+
+    // deonice razvijene po segmentu, sejder ne mora da trazi niz
+    struct Segment {
+        GLuint type;
+        GLfloat targetSpeed;
+    };
+    std::vector<Segment> segments(pointCount - 1, Segment{ 0, 0.0f });
+    for (const TrackRun& run : trackRuns) {
+        for (int i = run.firstSegment; i < run.endSegment && i < pointCount - 1; ++i) {
+            segments[i] = { static_cast<GLuint>(run.type), run.targetSpeed };
+        }
+    }
+
+    FleetStats stats = {};
+    // Partial u fleet_stats.comp: tri float i tri uint
+    const GLsizeiptr partialSize = 6 * sizeof(GLuint);
+
+    glGenBuffers(BUFFER_COUNT, buffers);
+    struct Upload {
+        Buffer buffer;
+        GLsizeiptr size;
+        const void* data;
+    };
+    const Upload uploads[] = {
+        { TRAINS, static_cast<GLsizeiptr>(trains.size() * sizeof(FleetTrain)), trains.data() },
+        { TRACK_S, static_cast<GLsizeiptr>(trackS.size() * sizeof(float)), trackS.data() },
+        { TRACK_POINTS, static_cast<GLsizeiptr>(points.size() * sizeof(GLfloat)), points.data() },
+        { SEGMENTS, static_cast<GLsizeiptr>(segments.size() * sizeof(Segment)), segments.data() },
+        { STATS, static_cast<GLsizeiptr>(sizeof(FleetStats)), &stats },
+        { PARTIALS, groupCount * partialSize, nullptr },
+    };
+    for (const Upload& upload : uploads) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[upload.buffer]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, upload.size, upload.data, GL_DYNAMIC_COPY);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, upload.buffer, buffers[upload.buffer]);
+    }
+
+    params.trainCount = static_cast<GLuint>(trainCount);
+    params.pointCount = static_cast<GLuint>(pointCount);
+    params.waitTicks = static_cast<GLuint>(std::ceil(WAIT_TIME / TIMER_WHEEL_TICK)); // kao TimerWheel::schedule
+    params.dt = static_cast<float>(FLEET_STEP);
+    params.trackLength = fleetTrack.trackTotalLength;
+    params.startSHead = fleetTrack.train.startSHead;
+    params.slopeDs = fleetTrack.trackTotalLength / NUM_TRACK_POINTS; // kao u integrateRun
+    params.startAccel = START_ACCEL;
+    params.gravityAccel = GRAVITY_ACCEL;
+    params.launchAccel = LAUNCH_ACCEL;
+    params.brakeDecel = BRAKE_DECEL;
+    params.maxSpeed = MAX_SPEED;
+    params.minSpeed = MIN_SPEED;
+    params.returnSpeed = RETURN_SPEED;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffers[PARAMS]);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Params), &params, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, buffers[PARAMS]);
+    return true;
+}
+
+void FleetSimGpu::step()
+{
+    // tikovi koje bi TimerWheel CPU flote obradio u ovom koraku
+    params.tickBefore = static_cast<GLuint>(clock.now());
+    clock.advance(FLEET_STEP, expired);
+    params.tickAfter = static_cast<GLuint>(clock.now());
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffers[PARAMS]);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Params), &params);
+
+    glUseProgram(stepProgram);
+    glDispatchCompute(groupCount, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+FleetStats FleetSimGpu::readStats()
+{
+    glUseProgram(statsProgram);
+    glUniform1ui(statsStageLocation, 0);
+    glUniform1ui(statsCountLocation, static_cast<GLuint>(trainCount));
+    glDispatchCompute(groupCount, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    glUniform1ui(statsStageLocation, 1);
+    glUniform1ui(statsCountLocation, static_cast<GLuint>(groupCount));
+    glDispatchCompute(1, 1, 1);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    FleetStats stats = {};
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[STATS]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(FleetStats), &stats);
+    return stats;
+}
+
+void FleetSimGpu::readTrains(int first, int count, std::vector<FleetTrain>& out)
+{
+    out.resize(count);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[TRAINS]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, first * sizeof(FleetTrain), count * sizeof(FleetTrain),
+        out.data());
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <GL/glew.h>
+
+#include "Ride.h"
+#include "TimerWheel.h"
+
+#include <vector>
+
+// korak flote, isti kao korak simulacione niti
+const double FLEET_STEP = 1.0 / 240.0;
+// niti u jednoj radnoj grupi oba compute sejdera
+const int FLEET_GROUP_SIZE = 256;
+
+// faze voza u floti, samo one u kojima voz provede vise od jednog koraka
+const GLuint FLEET_RUNNING = 0;
+const GLuint FLEET_WAITING = 1;
+const GLuint FLEET_RETURNING = 2;
+const int FLEET_PHASES = 3;
+
+// FleetTrain
+// Stanje jednog voza u SSBO (std430), isto kao u fleet_step.comp.
+struct FleetTrain {
+    GLfloat sHead;
+    GLfloat speed;
+    GLuint phase;
+    GLuint expireTick; // tik TimerWheel-a kad istice cekanje pre povratka
+};
+
+// FleetStats
+// Zbirni podaci cele flote, jedino sto se u merenju cita sa GPU.
+struct FleetStats {
+    GLuint rides;      // stigli do kraja staze od pocetka
+    GLuint phaseCount[FLEET_PHASES];
+    GLfloat sumS;
+    GLfloat sumSpeed;
+    GLfloat maxSpeed;
+    GLuint padding;
+};
+
+// FleetTrack
+// Staza i voz koje dele CPU i GPU flota, samo se citaju.
+struct FleetTrack {
+    const std::vector<Vertex>* vertices;
+    const std::vector<float>* trackS;
+    const std::vector<TrackRun>* trackRuns;
+    float trackTotalLength;
+    TrainLayout train;
+};
+
+// pocetno stanje voza k od trainCount: u voznji, rasporedjeni duz staze
+FleetTrain initialFleetTrain(const FleetTrack& track, int k, int trainCount);
+
+// FleetSimCpu
+// Referentna flota: svaki voz je RideState kroz updateState (bez tabele) i
+// TimerWheel. Vozovi nemaju hitne situacije, a u stanici se odmah
+// iskrcavaju, ukrcavaju i polaze ponovo.
+class FleetSimCpu {
+public:
+    void init(const FleetTrack& fleetTrack, int trainCount);
+    void step();
+
+    FleetTrain train(int k) const;
+    FleetStats stats() const;
+
+private:
+    FleetTrack track = {};
+    std::vector<RideState> rides;
+    TimerWheel timers;
+    std::vector<TimerExpiry> expired;
+    RideTrajectory noTrajectory; // prazna -> integracija kao u integrateRun
+    GLuint rideCount = 0;
+};
+
+// FleetSimGpu
+// Ista flota u SSBO, jedan dispatch fleet_step.comp po koraku. Zbirni
+// podaci se racunaju redukcijom u fleet_stats.comp, pa se po koraku sa GPU
+// ne cita nista, a readStats cita samo FleetStats.
+class FleetSimGpu {
+public:
+    // false ako sejderi nisu prevedeni ili flota ne staje u jedan dispatch
+    bool init(const FleetTrack& fleetTrack, int trainCount, const char* stepPath, const char* statsPath);
+    void step();
+
+    FleetStats readStats();
+    // stanje vozova [first, first + count), samo za proveru prema CPU
+    void readTrains(int first, int count, std::vector<FleetTrain>& out);
+
+private:
+    // isto kao blok Params u fleet_step.comp (std140, samo skalari)
+    struct Params {
+        GLuint trainCount;
+        GLuint pointCount;
+        GLuint tickBefore;
+        GLuint tickAfter;
+        GLuint waitTicks;
+        GLfloat dt;
+        GLfloat trackLength;
+        GLfloat startSHead;
+        GLfloat slopeDs;
+        GLfloat startAccel;
+        GLfloat gravityAccel;
+        GLfloat launchAccel;
+        GLfloat brakeDecel;
+        GLfloat maxSpeed;
+        GLfloat minSpeed;
+        GLfloat returnSpeed;
+    };
+
+    // redni broj SSBO je i njegov binding u sejderima, Params je uniform blok 0
+    enum Buffer {
+        TRAINS, TRACK_S, TRACK_POINTS, SEGMENTS, STATS, PARTIALS, PARAMS, BUFFER_COUNT
+    };
+
+    int trainCount = 0;
+    int groupCount = 0;
+    GLuint stepProgram = 0;
+    GLuint statsProgram = 0;
+    GLint statsStageLocation = -1;
+    GLint statsCountLocation = -1;
+    GLuint buffers[BUFFER_COUNT] = {};
+    Params params = {};
+    TimerWheel clock; // bez tajmera, samo broji tikove kao CPU flota
+    std::vector<TimerExpiry> expired;
+};
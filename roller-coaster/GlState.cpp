@@ -0,0 +1,93 @@
+#include "GlState.h"
+
+#include <iostream>
+
+bool GlStateCache::change(GLuint& cached, GLuint value)
+{
+    if (cached == value) {
+        ++skipped;
+        return false;
+    }
+    cached = value;
+    ++issued;
+    return true;
+}
+
+void GlStateCache::useProgram(GLuint value)
+{
+    if (change(program, value)) glUseProgram(value);
+}
+
+void GlStateCache::bindVertexArray(GLuint value)
+{
+    if (change(vao, value)) glBindVertexArray(value);
+}
+
+void GlStateCache::bindFramebuffer(GLuint value)
+{
+    if (change(fbo, value)) glBindFramebuffer(GL_FRAMEBUFFER, value);
+}
+
+void GlStateCache::activeTexture(int unit)
+{
+    if (change(activeUnit, static_cast<GLuint>(unit))) glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GlStateCache::bindTexture(int unit, GLenum target, GLuint texture)
+{
+    GLuint& cached = target == GL_TEXTURE_2D_ARRAY ? texture2DArray[unit]
+        : target == GL_TEXTURE_BUFFER ? textureBuffer[unit]
+        : texture2D[unit];
+    if (cached == texture) {
+        ++skipped;
+        return;
+    }
+    activeTexture(unit);
+    cached = texture;
+    ++issued;
+    glBindTexture(target, texture);
+}
+
+void GlStateCache::setEnabled(GLenum cap, bool enabled)
+{
+    GLuint& cached = cap == GL_BLEND ? blend : scissor;
+    if (!change(cached, enabled ? 1u : 0u)) return;
+    if (enabled) glEnable(cap);
+    else glDisable(cap);
+}
+
+void GlStateCache::bindUniformRange(GLuint binding, GLuint buffer, size_t offset, size_t size)
+{
+    UniformRange& cached = uniformRanges[binding];
+    if (cached.buffer == buffer && cached.offset == offset && cached.size == size) {
+        ++skipped;
+        return;
+    }
+    cached = { buffer, offset, size };
+    ++issued;
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, offset, size);
+}
+
+void GlStateCache::invalidate()
+{
+    program = UNKNOWN;
+    vao = UNKNOWN;
+    fbo = UNKNOWN;
+    activeUnit = UNKNOWN;
+    for (int unit = 0; unit < GL_STATE_TEXTURE_UNITS; ++unit) {
+        texture2D[unit] = UNKNOWN;
+        texture2DArray[unit] = UNKNOWN;
+        textureBuffer[unit] = UNKNOWN;
+    }
+    blend = UNKNOWN;
+    scissor = UNKNOWN;
+    for (UniformRange& range : uniformRanges) range = { UNKNOWN, 0, 0 };
+}
+
+void GlStateCache::printReport() const
+{
+    long long total = issued + skipped;
+    std::cout << "GL stanje: izdato " << issued << ", preskoceno " << skipped << " poziva";
+    if (total > 0) std::cout << " (" << 100.0 * skipped / total << "%)";
+    std::cout << std::endl;
+}
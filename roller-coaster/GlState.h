@@ -0,0 +1,59 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <cstddef>
+
+// jedinice tekstura i tacke vezivanja uniform blokova koje kes prati
+const int GL_STATE_TEXTURE_UNITS = 4;
+const int GL_STATE_UNIFORM_BINDINGS = 2;
+
+// GlStateCache
+// Pamti sta je poslednje postavljeno (program, VAO, framebuffer, teksture po
+// jedinici, opsezi uniform blokova i glEnable) i preskace pozive koji nista
+// ne menjaju. glActiveTexture se zove tek kad treba da se promeni
+// veza na drugoj jedinici. Kod koji menja ovo stanje mimo kesa posle toga
+// zove invalidate().
+class GlStateCache {
+public:
+    GlStateCache() { invalidate(); }
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void bindFramebuffer(GLuint fbo);
+    void bindTexture(int unit, GLenum target, GLuint texture); // 2D, 2D_ARRAY ili BUFFER
+    void setEnabled(GLenum cap, bool enabled); // GL_BLEND i GL_SCISSOR_TEST
+    void bindUniformRange(GLuint binding, GLuint buffer, size_t offset, size_t size);
+
+    // sve postaje nepoznato, sledeci poziv se uvek izdaje
+    void invalidate();
+
+    long long issuedCalls() const { return issued; }
+    long long skippedCalls() const { return skipped; }
+    void printReport() const;
+
+private:
+    static const GLuint UNKNOWN = 0xFFFFFFFFu;
+
+    // true ako vrednost treba postaviti, i odmah je pamti
+    bool change(GLuint& cached, GLuint value);
+    void activeTexture(int unit);
+
+    GLuint program;
+    GLuint vao;
+    GLuint fbo;
+    GLuint activeUnit;
+    GLuint texture2D[GL_STATE_TEXTURE_UNITS];
+    GLuint texture2DArray[GL_STATE_TEXTURE_UNITS];
+    GLuint textureBuffer[GL_STATE_TEXTURE_UNITS];
+    GLuint blend;
+    GLuint scissor;
+    struct UniformRange {
+        GLuint buffer;
+        size_t offset;
+        size_t size;
+    };
+    UniformRange uniformRanges[GL_STATE_UNIFORM_BINDINGS];
+
+    long long issued = 0;
+    long long skipped = 0;
+};
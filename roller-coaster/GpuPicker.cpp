@@ -0,0 +1,139 @@
+#include "GpuPicker.h"
+#include "Util.h"
+#include "UniformBlocks.h"
+#include "PackedVertex.h"
+#include "TrackTextures.h"
+
+#include <iostream>
+
+bool GpuPicker::init(int width, int height, const char* vertPath, const char* fragPath)
+{
+    this->width = width;
+    this->height = height;
+
+    program = createShader(vertPath, fragPath);
+    bindUniformBlocks(program);
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "uSprites"), 0);
+    glUniform1i(glGetUniformLocation(program, "uAtlas"), 1);
+    setTrackSamplers(program);
+
+    // ID-evi, 0 znaci da pod kursorom nema nicega
+    glGenTextures(1, &idTexture);
+    glBindTexture(GL_TEXTURE_2D, idTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, width, height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, idTexture, 0);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        std::cout << "Framebuffer za picking nije kompletan, koristi se picking na CPU." << std::endl;
+        return false;
+    }
+
+    // svaki slot cita jedan piksel
+    for (Slot& slot : slots) {
+        glGenBuffers(1, &slot.pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(GLuint), NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
+void GpuPicker::renderIds(GlStateCache& gl,
+    std::deque<InputEvent>& clicks,
+    GLuint trainVAO,
+    int instanceFloats,
+    GLuint spriteTexture,
+    bool spriteAtlas,
+    UniformBlocks& uniforms,
+    const InstancedDraw* draws,
+    int drawCount)
+{
+    if (clicks.empty() || busySlots == PICK_SLOTS) return;
+
+    gl.bindFramebuffer(fbo);
+    gl.useProgram(program);
+    gl.bindVertexArray(trainVAO);
+    if (spriteAtlas) gl.bindTexture(1, GL_TEXTURE_2D, spriteTexture);
+    else gl.bindTexture(0, GL_TEXTURE_2D_ARRAY, spriteTexture);
+    gl.setEnabled(GL_BLEND, false);
+    gl.setEnabled(GL_SCISSOR_TEST, true);
+
+    const GLsizei stride = instanceFloats * sizeof(float);
+
+    while (!clicks.empty() && busySlots < PICK_SLOTS) {
+        InputEvent click = clicks.front();
+        clicks.pop_front();
+
+        int px = static_cast<int>((click.xNdc + 1.0f) * 0.5f * width);
+        int py = static_cast<int>((click.yNdc + 1.0f) * 0.5f * height);
+        if (px < 0 || px >= width || py < 0 || py >= height) continue;
+
+        // crta se i cisti samo piksel pod kursorom
+        glScissor(px, py, 1, 1);
+        const GLuint clearId[4] = { 0, 0, 0, 0 };
+        glClearBufferuiv(GL_COLOR, 0, clearId);
+
+        for (int d = 0; d < drawCount; ++d) {
+            const InstancedDraw& draw = draws[d];
+            if (draw.instanceCount == 0) continue;
+
+            uniforms.bindPass(gl, draw.pickPass);
+            size_t first = draw.firstInstance * instanceFloats * sizeof(float);
+            glBindBuffer(GL_ARRAY_BUFFER, draw.instanceBuffer);
+            glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride, (void*)first);
+            glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, stride, (void*)(first + sizeof(float)));
+            drawQuadInstanced(draw.firstVertex, draw.instanceCount);
+        }
+
+        // citanje ide u PBO, glReadPixels se vraca odmah
+        Slot& slot = slots[(firstSlot + busySlots) % PICK_SLOTS];
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        glReadPixels(px, py, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, (void*)0);
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.clickTime = click.time;
+        ++busySlots;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    gl.setEnabled(GL_SCISSOR_TEST, false);
+    gl.setEnabled(GL_BLEND, true);
+    gl.bindFramebuffer(0);
+}
+
+void GpuPicker::poll(InputQueue& queue)
+{
+    while (busySlots > 0) {
+        Slot& slot = slots[firstSlot];
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+
+        glDeleteSync(slot.fence);
+        slot.fence = 0;
+
+        GLuint id = 0;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        const GLuint* mapped = static_cast<const GLuint*>(
+            glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(GLuint), GL_MAP_READ_BIT));
+        if (mapped) {
+            id = *mapped;
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        // simulacija dobija samo pogodjene putnike
+        if (id & PICK_PASSENGER_BIT) {
+            int seat = static_cast<int>(id & ~PICK_PASSENGER_BIT) - 1;
+            queue.push({ InputEventType::PickResult, seat, 0.0f, 0.0f, slot.clickTime });
+        }
+
+        firstSlot = (firstSlot + 1) % PICK_SLOTS;
+        --busySlots;
+    }
+}
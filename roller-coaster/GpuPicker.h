@@ -0,0 +1,75 @@
+#pragma once
+#include <GL/glew.h>
+
+#include "Input.h"
+#include "GlState.h"
+
+#include <deque>
+
+class UniformBlocks;
+
+// bit u ID-u koji oznacava putnika, bez njega je ID vagon
+const GLuint PICK_PASSENGER_BIT = 0x80000000u;
+// koliko klikova moze istovremeno da ceka na GPU
+const int PICK_SLOTS = 3;
+
+// slojevi niza tekstura voza, sloj se bira po instanci
+const int LAYER_PASSENGER = 0;
+const int LAYER_SEATBELT = 1;
+const int LAYER_SICK = 2;
+const int LAYER_CAR = 3;
+const int SPRITE_LAYERS = 4;
+
+// InstancedDraw
+// Jedan instancirani poziv iz render-a: kvadrat i opseg instanci u
+// instanceBuffer, teksture su slojevi istog niza ili delovi atlasa. ID pass
+// ponavlja iste pozive.
+struct InstancedDraw {
+    int firstVertex;
+    GLuint instanceBuffer;
+    int firstInstance;
+    int instanceCount;
+    int pickPass;  // PASS_PICK_* sa ID bitovima ovog poziva
+};
+
+// GpuPicker
+// Opcioni picking na GPU: za piksel pod kursorom crta ID vagona i putnika
+// u celobrojni attachment (samo taj piksel, kroz scissor) i cita ga u PBO
+// bez cekanja. Rezultat stize nekoliko frejmova kasnije i salje se
+// simulaciji kao InputEventType::PickResult. Piksel je providan ako je
+// providna tekstura, pa rotirani i preklopljeni sprajtovi daju tacan pogodak.
+class GpuPicker {
+public:
+    bool init(int width, int height, const char* vertPath, const char* fragPath);
+
+    // posle render-a, sa jos vezanim TrackTextures: ID pass za klikove koji
+    // cekaju i za koje ima slobodan slot, obradjeni klikovi se skidaju sa clicks
+    void renderIds(GlStateCache& gl,
+        std::deque<InputEvent>& clicks,
+        GLuint trainVAO,
+        int instanceFloats,
+        GLuint spriteTexture, // niz tekstura ili atlas
+        bool spriteAtlas,
+        UniformBlocks& uniforms,
+        const InstancedDraw* draws,
+        int drawCount);
+
+    // na pocetku frejma: zavrseni klikovi idu simulaciji kroz queue
+    void poll(InputQueue& queue);
+
+private:
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = 0;
+        double clickTime = 0.0;
+    };
+
+    int width = 0;
+    int height = 0;
+    GLuint program = 0;
+    GLuint fbo = 0;
+    GLuint idTexture = 0;
+    Slot slots[PICK_SLOTS]; // prsten, najstariji klik je na firstSlot
+    int firstSlot = 0;
+    int busySlots = 0;
+};
@@ -0,0 +1,45 @@
+#include "Input.h"
+
+#include <GLFW/glfw3.h>
+
+static void keyCallback(GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/)
+{
+    // drzanje tastera se ne ponavlja, broji se samo pritisak
+    if (action != GLFW_PRESS) return;
+
+    // izlaz se obradjuje odmah, na niti prozora
+    if (key == GLFW_KEY_ESCAPE) {
+        glfwSetWindowShouldClose(window, GLFW_TRUE);
+        return;
+    }
+
+    InputTargets* targets = static_cast<InputTargets*>(glfwGetWindowUserPointer(window));
+    targets->queue->push({ InputEventType::Key, key, 0.0f, 0.0f, glfwGetTime() });
+}
+
+static void mouseButtonCallback(GLFWwindow* window, int button, int action, int /*mods*/)
+{
+    if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS) return;
+
+    double mouseX, mouseY;
+    glfwGetCursorPos(window, &mouseX, &mouseY);
+
+    int fbWidth, fbHeight;
+    glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+    //konverzija u ndc
+    float xNdc = 2.0f * static_cast<float>(mouseX) / fbWidth - 1.0f;
+    float yNdc = -2.0f * static_cast<float>(mouseY) / fbHeight + 1.0f;
+
+    InputEvent click = { InputEventType::MouseClick, button, xNdc, yNdc, glfwGetTime() };
+    InputTargets* targets = static_cast<InputTargets*>(glfwGetWindowUserPointer(window));
+    if (targets->clicks) targets->clicks->push_back(click);
+    else targets->queue->push(click);
+}
+
+void installInputCallbacks(GLFWwindow* window, InputTargets* targets)
+{
+    glfwSetWindowUserPointer(window, targets);
+    glfwSetKeyCallback(window, keyCallback);
+    glfwSetMouseButtonCallback(window, mouseButtonCallback);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "SpscQueue.h"
+
+#include <deque>
+
+struct GLFWwindow;
+
+enum class InputEventType : unsigned char {
+    Key,        // pritisnut taster (key je GLFW_KEY_*)
+    MouseClick, // levi klik, x i y su u NDC
+    PickResult  // putnik pogodjen GPU picking-om, key je sediste
+};
+
+struct InputEvent {
+    InputEventType type;
+    int key;
+    float xNdc;
+    float yNdc;
+    double time; // glfwGetTime() u trenutku dogadjaja
+};
+
+typedef SpscQueue<InputEvent, 256> InputQueue;
+
+// InputTargets
+// Kuda callback-ovi salju dogadjaje. Ako je clicks postavljen, klikovi
+// ostaju na glavnoj niti za GPU picking, inace idu simulaciji kao i tasteri.
+struct InputTargets {
+    InputQueue* queue = nullptr;
+    std::deque<InputEvent>* clicks = nullptr;
+};
+
+// installInputCallbacks
+// GLFW callback-ovi upisuju pritiske tastera i klikove u red, a simulacija
+// ih prazni. Nijedan kratak pritisak izmedju dva frejma se ne gubi.
+void installInputCallbacks(GLFWwindow* window, InputTargets* targets);
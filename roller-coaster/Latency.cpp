@@ -0,0 +1,57 @@
+#include "Latency.h"
+
+#include <algorithm>
+#include <iostream>
+
+void LatencyTracker::onInputApplied(LatencyKind kind, double inputTime)
+{
+    currentFrame.push_back({ kind, inputTime });
+}
+
+void LatencyTracker::onFrameSubmitted()
+{
+    if (currentFrame.empty()) return;
+
+    PendingFrame frame;
+    frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame.stamps.swap(currentFrame);
+    pendingFrames.push_back(std::move(frame));
+}
+
+void LatencyTracker::pollPresented(double now)
+{
+    while (!pendingFrames.empty()) {
+        PendingFrame& frame = pendingFrames.front();
+        GLenum status = glClientWaitSync(frame.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+
+        for (const Stamp& stamp : frame.stamps) {
+            samples[static_cast<int>(stamp.kind)].push_back(now - stamp.inputTime);
+        }
+        glDeleteSync(frame.fence);
+        pendingFrames.pop_front();
+    }
+}
+
+void LatencyTracker::printReport() const
+{
+    static const char* names[] = { "ENTER", "1-8", "ostalo" };
+
+    std::cout << "Kasnjenje ulaz -> slika (ms):" << std::endl;
+    for (int k = 0; k < static_cast<int>(LatencyKind::Count); ++k) {
+        if (samples[k].empty()) continue;
+
+        std::vector<double> sorted = samples[k];
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&](double p) {
+            size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+            return sorted[index] * 1000.0;
+        };
+
+        std::cout << "  " << names[k] << ": p50 " << percentile(0.50)
+            << ", p90 " << percentile(0.90)
+            << ", p99 " << percentile(0.99)
+            << ", max " << sorted.back() * 1000.0
+            << " (n = " << sorted.size() << ")" << std::endl;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <vector>
+#include <deque>
+
+enum class LatencyKind : unsigned char {
+    Dispatch,   // ENTER
+    Emergency,  // tasteri 1-8
+    Other,      // SPACE, klik
+    Count
+};
+
+// LatencyTracker
+// Meri vreme od ulaza (vreme iz GLFW callback-a) do trenutka kad je GPU
+// zavrsio frejm u kome se promena prvi put vidi. Posle glfwSwapBuffers
+// se ubacuje fence, a on se proverava bez cekanja na pocetku sledecih
+// frejmova, pa je izmereno vreme gornja granica (do jednog frejma vise).
+// Frejm bez novih ulaza ne pravi fence.
+class LatencyTracker {
+public:
+    // ulaz koji je u ovom frejmu promenio stanje
+    void onInputApplied(LatencyKind kind, double inputTime);
+    // odmah posle glfwSwapBuffers
+    void onFrameSubmitted();
+    // proverava ranije predate frejmove
+    void pollPresented(double now);
+
+    void printReport() const;
+
+private:
+    struct Stamp {
+        LatencyKind kind;
+        double inputTime;
+    };
+
+    struct PendingFrame {
+        GLsync fence;
+        std::vector<Stamp> stamps;
+    };
+
+    std::vector<Stamp> currentFrame;
+    std::deque<PendingFrame> pendingFrames;
+    std::vector<double> samples[static_cast<int>(LatencyKind::Count)];
+};
@@ -3,58 +3,39 @@
 
 #include <iostream>
 #include "Util.h"
+#include "Ride.h"
+#include "StationSim.h"
+#include "Input.h"
+#include "Latency.h"
+#include "SimThread.h"
+#include "Train.h"
+#include "GpuPicker.h"
+#include "Atlas.h"
+#include "StreamBuffer.h"
+#include "GlState.h"
+#include "UniformBlocks.h"
+#include "PackedVertex.h"
+#include "TrackRenderer.h"
+#include "TrackTextures.h"
+#include "FleetSim.h"
 
 #include <vector>
 #include <cmath>
 
 #include <thread>
 #include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <deque>
 
 #include <algorithm>
 #include "stb_image.h"
 
 
-struct Vertex {
-    float x, y;
-    float u, v;
-    float r, g, b;
-};
-
-// KONSTANTE ZA STAZU
-constexpr int   NUM_TRACK_POINTS = 200;
-constexpr float NUM_HILLS = 5.0f;
-
-// KONSTANTE ZA VAGON
-constexpr int   WAGON_SEGMENTS = 8;
-constexpr int   WAGON_VERTEX_COUNT_PER_SEGMENT = 4;
-constexpr float WAGON_SEGMENT_SIZE = 0.1f;
-constexpr float WAGON_Y_BOTTOM = -0.9f;
-constexpr float WAGON_Y_TOP = WAGON_Y_BOTTOM + WAGON_SEGMENT_SIZE;
-// Pocetni x za prvi segment (pre pomeranja po stazi).
-constexpr float WAGON_X_START = -0.3f;
-constexpr float WAGON_GAP = 0.002f;
-constexpr int   PASSENGER_VERTEX_COUNT_PER_SEGMENT = 4;
-
 // animacione promenljive / konstante
 const double TARGET_FRAME_TIME = 1.0 / 75.0;
-
-// ubrzanje i brzina
-const float START_ACCEL = 0.4f;
-const float GRAVITY_ACCEL = 1.8f;
-const float MAX_SPEED = 1.6f;
-const float MIN_SPEED = 0.1f;
-
-// konstanta brzina povratka
-const float RETURN_SPEED = 0.8f;
-const float EMERGENCY_RETURN_SPEED = 0.3f;
-// negativno ubrzanje
-const float EMERGENCY_DECEL = 1.2f;
-
-const float SEGMENT_SPACING = WAGON_SEGMENT_SIZE + WAGON_GAP;
-const float START_S_HEAD = (WAGON_SEGMENTS - 1) * SEGMENT_SPACING;
-
-const double WAIT_TIME = 3.0;
-const double EMERGENCY_WAIT_TIME = 10.0;
+// debljina staze u delu visine prozora
+const float TRACK_WIDTH = 1.0f / 180.0f;
 
 int endProgram(std::string message) {
     std::cout << message << std::endl;
@@ -75,137 +56,6 @@ void preprocessTexture(unsigned& texture, const char* filepath) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 }
 
-// buildTrack
-// Popunjava:
-// - vertices: tacke staze
-// - trackS:   kumulativne duzine duz staze
-// - trackTotalLength: ukupna duzina staze
-void buildTrack(std::vector<Vertex>& vertices,
-    std::vector<float>& trackS, // trackS[i] je duzina staze do verteksa i
-    float& trackTotalLength)
-{
-    vertices.clear();
-    vertices.reserve(NUM_TRACK_POINTS);
-
-    for (int i = 0; i < NUM_TRACK_POINTS; ++i) {
-        float t = i / float(NUM_TRACK_POINTS - 1);
-
-        float x = -0.9f + t * 1.8f;        // x se linijski menja od -0.9 do 0.9
-        float bigHill = std::sin(3.14159f * (t + 0.1f));                 // 1 veliko brdo
-        float midHill = 0.6f * std::sin(3.0f * 3.14159f * (t - 0.15f));  // 3 srednja
-        float smallWiggle = 0.3f * std::sin(8.0f * 3.14159f * t);           // sitne neravnine
-
-        float hills = bigHill + midHill + smallWiggle;
-        float yBase = -0.45f;
-        float yAmp = 0.42f;
-
-        float y = yBase + yAmp * hills;
-        vertices.push_back({ x, y, 0.0f, 0.0f, 0.7f, 0.7f, 0.7f });
-    }
-
-    int trackVertexCount = NUM_TRACK_POINTS;
-
-    // trackS[i] zna razdaljinu od pocetka do verteksa i.
-    trackS.resize(trackVertexCount);
-    trackS[0] = 0.0f;
-    for (int i = 1; i < trackVertexCount; ++i) {
-        float dx = vertices[i].x - vertices[i - 1].x;
-        float dy = vertices[i].y - vertices[i - 1].y;
-        float dist = std::sqrt(dx * dx + dy * dy);
-        trackS[i] = trackS[i - 1] + dist;
-    }
-    // ukupna duzina staze je kumulativna duzina do poslednjeg verteksa
-    trackTotalLength = trackS[trackVertexCount - 1];
-}
-
-// buildTrain
-void buildTrain(std::vector<Vertex>& vertices,
-    std::vector<float>& segmentCenterX, //x centri segmenata
-    float& segmentCenterY, //y centri segmenata
-    int& wagonStartIndex, //startni segment u vertices
-    int& passengerStartIndex)
-{
-    segmentCenterX.assign(WAGON_SEGMENTS, 0.0f);
-    segmentCenterY = WAGON_Y_BOTTOM;
-    wagonStartIndex = static_cast<int>(vertices.size());
-
-    // Dodajem segmente vagona jedan iza drugog
-    for (int i = 0; i < WAGON_SEGMENTS; ++i) {
-        float x0 = WAGON_X_START + i * (WAGON_SEGMENT_SIZE + WAGON_GAP); // Levi x
-        float x1 = x0 + WAGON_SEGMENT_SIZE;                              // Desni x
-        float r = 0.2f, g = 0.4f, b = 0.9f;                              // boja vagona
-
-        segmentCenterX[i] = (x0 + x1) / 2.0f;
-
-        vertices.push_back({ x0, WAGON_Y_BOTTOM, 0.0f, 0.0f, r, g, b }); // dole levo
-        vertices.push_back({ x1, WAGON_Y_BOTTOM, 1.0f, 0.0f, r, g, b }); // dole desno
-        vertices.push_back({ x1, WAGON_Y_TOP,    1.0f, 1.0f, r, g, b }); // gore desno
-        vertices.push_back({ x0, WAGON_Y_TOP,    0.0f, 1.0f, r, g, b }); // gore levo
-    }
-
-    //segmenti za putnike
-    passengerStartIndex = static_cast<int>(vertices.size());
-    for (int i = 0; i < WAGON_SEGMENTS; ++i) {
-        float x0 = WAGON_X_START + i * (WAGON_SEGMENT_SIZE + WAGON_GAP);
-        float x1 = x0 + WAGON_SEGMENT_SIZE;
-
-        //margine za uvlacenje teksture putnika unutra
-        float marginX = 0.015f;
-        float marginYBottom = 0.01f;
-        float marginYTop = 0.02f;
-
-        float passengerYOffset = 0.04f;
-
-        float px0 = x0 + marginX;
-        float px1 = x1 - marginX;
-        float py0 = WAGON_Y_BOTTOM + marginYBottom + passengerYOffset;
-        float py1 = WAGON_Y_TOP - marginYTop + passengerYOffset;
-
-        float r = 1.0f, g = 1.0f, b = 1.0f;
-
-        vertices.push_back({ px0, py0, 0.0f, 0.0f, r, g, b }); // dole levo
-        vertices.push_back({ px1, py0, 1.0f, 0.0f, r, g, b }); // dole desno
-        vertices.push_back({ px1, py1, 1.0f, 1.0f, r, g, b }); // gore desno
-        vertices.push_back({ px0, py1, 0.0f, 1.0f, r, g, b }); // gore levo
-    }
-}
-
-// getPointOnTrack
-// Za datu duzinu s (udaljenost duz staze od pocetka) vraca tacku (x,y) na sinama
-void getPointOnTrack(float s, //duzina staze
-    float& outX,  // povratne koordinate x i y
-    float& outY,
-    const std::vector<Vertex>& vertices,
-    const std::vector<float>& trackS,
-    float trackTotalLength)
-{
-    const int TRACK_VERTEX_COUNT = static_cast<int>(trackS.size());
-
-    if (s < 0.0f)            s = 0.0f;
-    if (s > trackTotalLength) s = trackTotalLength;
-
-    //trazi indeks segmenta u kome se nalazi duzina s.
-    int i = 0;
-    while (i < TRACK_VERTEX_COUNT - 1 && trackS[i + 1] < s) {
-        ++i;
-    }
-
-    // duzina segmenta [i, i+1].
-    float segLen = trackS[i + 1] - trackS[i];
-    // razdaljina od pocetka segmenta do s
-    float tLocal = (segLen > 0.0f) ? (s - trackS[i]) / segLen : 0.0f;
-
-    // Koordinate krajeva segmenta
-    float x0 = vertices[i].x;
-    float y0 = vertices[i].y;
-    float x1 = vertices[i + 1].x;
-    float y1 = vertices[i + 1].y;
-
-    // pomeri se tLocal procenata unutar segmenta
-    outX = x0 + tLocal * (x1 - x0);
-    outY = y0 + tLocal * (y1 - y0);
-}
-
 void setupCursor(GLFWwindow* window)
 {
     int curWidth, curHeight, curChannels;
@@ -262,385 +112,316 @@ void setupCursor(GLFWwindow* window)
     glfwSetCursor(window, cursor);
 }
 
-void handleKeyboardInput(
-    GLFWwindow* window,
-    bool& spaceWasPressed,
-    bool& enterWasPressed,
-    bool& isRunning,
-    bool& isReturning,
-    bool& isEmergencyDecel,
-    bool& isEmergencyWaiting,
-    bool& isDisembarking,
-    int& passengersCount,
-    std::vector<bool>& segmentHasPassenger,
-    std::vector<bool>& passengerBuckled,
-    std::vector<bool>& passengerSick,
-    int& sickPassengerIndex,
-    bool& returnFromEmergency
+// instanca vagona ili putnika: indeks vagona i sloj teksture, polozaj na
+// stazi racuna sejder iz indeksa
+const int INSTANCE_FLOATS = 2;
+// svi vagoni, pa svi putnici
+const int MAX_TRAIN_DRAWS = 2;
+
+void render(
+    GlStateCache& gl,
+    GLuint basicShader,
+    TrackRenderer& track,
+    GLuint quadVAO,      // kvadrati voza i imena
+    GLuint trainVAO,     // isti kvadrati + indeks vagona i sloj po instanci
+    const TrackTextures& trackTextures,
+    GLuint carInstances,     // staticne instance vagona, redom
+    StreamBuffer& instances, // instance putnika, upisuju se direktno u bafer
+    UniformBlocks& uniforms, // vec upisani za ovaj frejm
+    int WAGON_START_INDEX,     // indeksi kvadrata su u toku kvadrata
+    int PASSENGER_START_INDEX,
+    int NAME_QUAD_START,
+    const SeatMask& segmentHasPassenger,
+    const SeatMask& passengerBuckled,
+    const SeatMask& passengerSick,
+    int carCount,
+    GLuint spriteTexture, // niz sa slojevima LAYER_* ili atlas
+    bool spriteAtlas,
+    bool showSick,        // sprajt bolesnog putnika je ucitan
+    GLuint nameTexture,
+    InstancedDraw* draws, // izlaz: pozivi za vagone i putnike, za ID pass
+    int& drawCount
 )
 {
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
-        glfwSetWindowShouldClose(window, GLFW_TRUE);
-    }
+    glClear(GL_COLOR_BUFFER_BIT);
 
-    // SPACE dodaje putnika
-    bool spaceNow = (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS);
-    if (!isRunning && !isReturning && !isEmergencyDecel && !isEmergencyWaiting && !isDisembarking && spaceNow && !spaceWasPressed) {
-        if (passengersCount < WAGON_SEGMENTS) {
-            segmentHasPassenger[passengersCount] = true;
-            passengersCount++;
-        }
+    bindTrackTextures(gl, trackTextures);
+    uniforms.bindPass(gl, PASS_TRACK);
+    track.draw(gl, basicShader);
+
+    // vagoni su uvek isti, pa se po frejmu pisu samo putnici, sloj bira
+    // teksturu putnika; bafer moze biti mapiran, pa se u njega samo pise redom
+    float* out = static_cast<float*>(instances.beginWrite());
+    int passengerCount = 0;
+    for (int i = segmentHasPassenger.nextSet(0); i >= 0; i = segmentHasPassenger.nextSet(i + 1)) {
+        int layer = LAYER_PASSENGER;
+        if (showSick && passengerSick.test(i)) layer = LAYER_SICK;
+        else if (passengerBuckled.test(i)) layer = LAYER_SEATBELT;
+        float* instance = out + passengerCount * INSTANCE_FLOATS;
+        instance[0] = static_cast<float>(i);
+        instance[1] = static_cast<float>(layer);
+        ++passengerCount;
     }
-    spaceWasPressed = spaceNow;
-
-    // ENTER pokrece voz samo ako su svi putnici vezani
-    bool enterNow = (glfwGetKey(window, GLFW_KEY_ENTER) == GLFW_PRESS);
-    if (enterNow && !enterWasPressed && !isRunning && !isReturning && !isEmergencyDecel && !isEmergencyWaiting && !isDisembarking) {
-        bool allSafe = true;
-        for (int i = 0; i < WAGON_SEGMENTS; ++i) {
-            if (segmentHasPassenger[i] && !passengerBuckled[i]) {
-                allSafe = false;
-                break;
-            }
-        }
-        if (allSafe && passengersCount>0) {
-            sickPassengerIndex = -1;
-            std::fill(passengerSick.begin(), passengerSick.end(), false);
-            returnFromEmergency = false;
 
-            isRunning = true;
-        }
+    const GLsizei stride = INSTANCE_FLOATS * sizeof(float);
+    int firstPassenger = static_cast<int>(instances.endWrite(passengerCount * stride) / stride);
+
+    gl.useProgram(basicShader);
+    gl.bindVertexArray(trainVAO);
+    uniforms.bindPass(gl, PASS_TRAIN);
+    if (spriteAtlas) gl.bindTexture(0, GL_TEXTURE_2D, spriteTexture);
+    else gl.bindTexture(1, GL_TEXTURE_2D_ARRAY, spriteTexture);
+
+    drawCount = 0;
+    draws[drawCount++] = { WAGON_START_INDEX, carInstances, 0, carCount, PASS_PICK_CARS };
+    draws[drawCount++] = { PASSENGER_START_INDEX, instances.buffer(), firstPassenger, passengerCount, PASS_PICK_PASSENGERS };
+
+    // jedan poziv za sve instance od firstInstance
+    for (int d = 0; d < drawCount; ++d) {
+        const InstancedDraw& draw = draws[d];
+        if (draw.instanceCount == 0) continue;
+
+        size_t first = draw.firstInstance * INSTANCE_FLOATS * sizeof(float);
+        glBindBuffer(GL_ARRAY_BUFFER, draw.instanceBuffer);
+        glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, stride, (void*)first);
+        glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, stride, (void*)(first + sizeof(float)));
+        drawQuadInstanced(draw.firstVertex, draw.instanceCount);
     }
-    enterWasPressed = enterNow;
-
-    // tasteri 1-8
-    if (isRunning && !isEmergencyDecel) {
-        for (int i = 0; i < WAGON_SEGMENTS; ++i) {
-            int key = GLFW_KEY_1 + i;
-            if (glfwGetKey(window, key) == GLFW_PRESS) {
-                if (segmentHasPassenger[i]) {
-                    passengerSick[i] = true;
-                    sickPassengerIndex = i;
-
-                    isEmergencyDecel = true;
-                }
-                // samo prvi pritisnut taster se prihvata
-                break;
-            }
-        }
+
+    gl.bindVertexArray(quadVAO);
+    gl.bindTexture(0, GL_TEXTURE_2D, nameTexture);
+    uniforms.bindPass(gl, PASS_NAME);
+
+    drawQuads(NAME_QUAD_START, 1);
+}
+
+// --simulate-day [broj_stanica] [gostiju_po_satu] [broj_vagona]
+// Simulira ceo radni dan stanica bez prozora i ispisuje statistiku.
+int simulateDay(int argc, char** argv)
+{
+    StationSimConfig config;
+    if (argc > 2) config.stationCount = std::max(1, std::atoi(argv[2]));
+    if (argc > 3) config.guestsPerHour = std::max(1.0, std::atof(argv[3]));
+    int carCount = argc > 4 ? std::atoi(argv[4]) : WAGON_SEGMENTS;
+
+    std::vector<Vertex> vertices;
+    std::vector<float>  trackS;
+    float trackTotalLength = 0.0f;
+    std::vector<TrackRun> trackRuns;
+    buildTrack(vertices, trackS, trackTotalLength);
+    TrainLayout train = makeTrainLayout(carCount, trackTotalLength);
+    buildTrackAttributes(vertices, trackS, train, trackRuns);
+
+    RideTrajectory trajectory;
+    buildRideTrajectory(trackS, trackTotalLength, vertices, trackRuns, train, TRAJECTORY_STEP, trajectory);
+
+    auto wallStart = std::chrono::steady_clock::now();
+    StationSimStats stats = runStationSimulation(config, trackTotalLength, train, trajectory);
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    std::cout << "Stanica: " << config.stationCount
+        << ", dolazaka po satu: " << config.guestsPerHour
+        << ", vagona: " << train.carCount << std::endl;
+    std::cout << "Trajanje voznje: " << stats.rideRunTime << " s" << std::endl;
+    std::cout << "Gostiju stiglo: " << stats.guestsArrived
+        << ", provozano: " << stats.guestsRidden
+        << ", voznji: " << stats.rides
+        << ", hitnih kocenja: " << stats.emergencies << std::endl;
+    if (stats.guestsRidden > 0) {
+        std::cout << "Prosecno cekanje u redu: " << stats.totalQueueWait / stats.guestsRidden
+            << " s, najduze: " << stats.maxQueueWait
+            << " s, najduzi red: " << stats.maxQueueLength << std::endl;
     }
+    std::cout << "Simulirano vreme: " << stats.simulatedTime / 3600.0 << " h, dogadjaja: "
+        << stats.eventsProcessed << ", za " << wallSeconds << " s" << std::endl;
+    return 0;
 }
 
-void updateState(
-    double deltaTime,
-    float& sHead,
-    float& currentSpeed,
-    bool& isRunning,
-    bool& isReturning,
-    bool& isWaitingBeforeReturn,
-    bool& isDisembarking,
-    double& waitTimer,
-    bool& isEmergencyDecel,
-    bool& isEmergencyWaiting,
-    double& emergencyWaitTimer,
-    bool& returnFromEmergency,
-    std::vector<bool>& passengerBuckled,
-    std::vector<bool>& passengerSick,
+// meri updateTrainOffsets za jedan tip voza, vraca ns po koraku
+template <typename TrainT>
+double timeTrainOffsets(TrainT& cars, int steps,
     const std::vector<float>& trackS,
     float trackTotalLength,
     const std::vector<Vertex>& vertices,
-    const std::vector<float>& segmentCenterX,
-    float segmentCenterY,
-    std::vector<float>& segOffsetX,
-    std::vector<float>& segOffsetY,
-    std::vector<bool>& segmentHasPassenger,
-    int& passengersCount
-)
+    const std::vector<TrackRun>& trackRuns,
+    const TrainLayout& train,
+    float& checksum)
 {
-    if (isRunning && !isEmergencyDecel) {
-        float maxHead = trackTotalLength;
-
-        // deo staze za racunanje nagiba
-        float ds = trackTotalLength / NUM_TRACK_POINTS;
-
-        float x0, y0, x1, y1;
-        getPointOnTrack(sHead, x0, y0, vertices, trackS, trackTotalLength);
-        getPointOnTrack(sHead + ds, x1, y1, vertices, trackS, trackTotalLength);
-
-        float dy = y1 - y0;            // ako je dy < 0 -> nizbrdica, dy > 0 -> uzbrdica
-
-        float accel = START_ACCEL + (-dy) * GRAVITY_ACCEL; //uzbrdo sporije, nizbrdo brze
-
-        // update brzine
-        currentSpeed += accel * static_cast<float>(deltaTime);
+    RideState& ride = cars.ride;
+    float range = trackTotalLength - train.startSHead;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int k = 0; k < steps; ++k) {
+        // glava ide napred kao u voznji, kursor prati kao u updateState
+        ride.sHead = train.startSHead + range * (k % 1000) / 1000.0f;
+        seekTrackCursor(ride.cursor, ride.sHead, trackS, trackRuns);
+        updateTrainOffsets(trackS, trackTotalLength, vertices, trackRuns, cars);
+        checksum += cars.offsetX[cars.carCount() - 1];
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds * 1e9 / steps;
+}
 
-        if (currentSpeed > MAX_SPEED) currentSpeed = MAX_SPEED;
-        if (currentSpeed < MIN_SPEED) currentSpeed = MIN_SPEED;
+// --benchmark-train [koraka]
+// Uporedjuje Train<N> i DynamicTrain za svaku prevedenu duzinu voza.
+int benchmarkTrain(int argc, char** argv)
+{
+    int steps = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000000;
 
-        // pomeranje po stazi
-        sHead += currentSpeed * static_cast<float>(deltaTime);
+    std::vector<Vertex> vertices;
+    std::vector<float>  trackS;
+    float trackTotalLength = 0.0f;
+    buildTrack(vertices, trackS, trackTotalLength);
 
-        if (sHead >= maxHead) {
-            sHead = maxHead;
-            isRunning = false;
-            currentSpeed = 0.0f;
-            isWaitingBeforeReturn = true;
-            waitTimer = 0.0;
-        }
+    const int carCounts[] = { 4, 8, 16, 32, 64 };
+    float checksum = 0.0f;
+    for (int carCount : carCounts) {
+        TrainLayout train = makeTrainLayout(carCount, trackTotalLength);
+        std::vector<TrackRun> trackRuns;
+        buildTrackAttributes(vertices, trackS, train, trackRuns);
+
+        double fixedNs = 0.0;
+        visitTrain(train, [&](auto& cars) {
+            fixedNs = timeTrainOffsets(cars, steps, trackS, trackTotalLength, vertices, trackRuns, train, checksum);
+        });
+
+        DynamicTrain dynamicCars(train);
+        double dynamicNs = timeTrainOffsets(dynamicCars, steps, trackS, trackTotalLength, vertices, trackRuns,
+            train, checksum);
+
+        std::cout << "Vagona: " << carCount
+            << ", Train<N>: " << fixedNs << " ns"
+            << ", DynamicTrain: " << dynamicNs << " ns po koraku" << std::endl;
     }
+    std::cout << "(kontrolni zbir " << checksum << ")" << std::endl;
+    return 0;
+}
 
-    if (isEmergencyDecel) {
-        currentSpeed -= EMERGENCY_DECEL * static_cast<float>(deltaTime);
-        if (currentSpeed < 0.0f) currentSpeed = 0.0f;
-
-        // voz se pomera jos malo dok ne stane
-        sHead += currentSpeed * static_cast<float>(deltaTime);
-
-        if (sHead > trackTotalLength) {
-            sHead = trackTotalLength;
-        }
+// deo flote koji se proverava prema CPU i dozvoljena razlika s i brzine
+const int FLEET_CHECK_TRAINS = 4096;
+const float FLEET_TOLERANCE = 1e-4f;
 
-        // ceka 10sekundi
-        if (currentSpeed <= 0.01f) {
-            currentSpeed = 0.0f;
-            isEmergencyDecel = false;
-            isRunning = false;
+static void printFleetStats(const char* label, const FleetStats& stats, int trainCount)
+{
+    std::cout << label << ": voznji " << stats.rides
+        << ", u voznji " << stats.phaseCount[FLEET_RUNNING]
+        << ", ceka " << stats.phaseCount[FLEET_WAITING]
+        << ", vraca se " << stats.phaseCount[FLEET_RETURNING]
+        << ", prosecno s " << stats.sumS / trainCount
+        << ", prosecna brzina " << stats.sumSpeed / trainCount
+        << ", najveca " << stats.maxSpeed << std::endl;
+}
 
-            isEmergencyWaiting = true;
-            emergencyWaitTimer = 0.0;
-            returnFromEmergency = true;  // znaci da se vraca sporije
-        }
-    }
+// --benchmark-fleet [vozova] [sekundi]
+// Flota vozova na compute sejderu (GL 4.3). Prvih FLEET_CHECK_TRAINS se
+// vozi i kroz updateState na CPU i poredi voz po voz, zatim se meri cela
+// flota na GPU uz citanje samo zbirnih podataka.
+int benchmarkFleet(int argc, char** argv)
+{
+    int trainCount = argc > 2 ? std::max(1, std::atoi(argv[2])) : 1000000;
+    double seconds = argc > 3 ? std::max(FLEET_STEP, std::atof(argv[3])) : 10.0;
+    int steps = static_cast<int>(std::ceil(seconds / FLEET_STEP));
 
-    if (isWaitingBeforeReturn) {
-        waitTimer += deltaTime;
+    glfwInit();
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(64, 64, "Flota", NULL, NULL);
+    if (window == NULL) return endProgram("Za --benchmark-fleet treba OpenGL 4.3 (compute sejderi).");
+    glfwMakeContextCurrent(window);
+    if (glewInit() != GLEW_OK) return endProgram("GLEW nije uspeo da se inicijalizuje.");
+    if (!GLEW_VERSION_4_3) return endProgram("Za --benchmark-fleet treba OpenGL 4.3 (compute sejderi).");
 
-        if (waitTimer >= WAIT_TIME) {
-            isWaitingBeforeReturn = false;
-            isReturning = true;
-        }
+    std::vector<Vertex> vertices;
+    std::vector<float>  trackS;
+    float trackTotalLength = 0.0f;
+    std::vector<TrackRun> trackRuns;
+    buildTrack(vertices, trackS, trackTotalLength);
+    TrainLayout train = makeTrainLayout(WAGON_SEGMENTS, trackTotalLength);
+    buildTrackAttributes(vertices, trackS, train, trackRuns);
+    FleetTrack track = { &vertices, &trackS, &trackRuns, trackTotalLength, train };
+
+    // provera: isti pocetak na CPU i GPU, posle svih koraka poredi se svaki voz
+    const int checkCount = std::min(trainCount, FLEET_CHECK_TRAINS);
+    FleetSimCpu cpu;
+    cpu.init(track, checkCount);
+    FleetSimGpu check;
+    if (!check.init(track, checkCount, "fleet_step.comp", "fleet_stats.comp")) {
+        return endProgram("Compute sejderi flote nisu spremni.");
     }
 
-    // ceka 10 sekundi
-    if (isEmergencyWaiting) {
-        emergencyWaitTimer += deltaTime;
-        if (emergencyWaitTimer >= EMERGENCY_WAIT_TIME) {
-            isEmergencyWaiting = false;
-            isReturning = true;
+    auto cpuStart = std::chrono::steady_clock::now();
+    for (int k = 0; k < steps; ++k) cpu.step();
+    double cpuSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - cpuStart).count();
+    for (int k = 0; k < steps; ++k) check.step();
+
+    std::vector<FleetTrain> gpuTrains;
+    check.readTrains(0, checkCount, gpuTrains);
+    float maxDs = 0.0f, maxDv = 0.0f;
+    int phaseMismatches = 0;
+    for (int k = 0; k < checkCount; ++k) {
+        FleetTrain c = cpu.train(k);
+        if (c.phase != gpuTrains[k].phase) {
+            ++phaseMismatches;
+            continue;
         }
+        maxDs = std::max(maxDs, std::fabs(c.sHead - gpuTrains[k].sHead));
+        maxDv = std::max(maxDv, std::fabs(c.speed - gpuTrains[k].speed));
     }
-
-    // povratak voza unazad konstantnom brzinom
-    if (isReturning) {
-        float usedReturnSpeed = returnFromEmergency ? EMERGENCY_RETURN_SPEED
-            : RETURN_SPEED;
-
-        sHead -= usedReturnSpeed * static_cast<float>(deltaTime);
-
-        if (sHead <= START_S_HEAD) {
-            sHead = START_S_HEAD;
-            isReturning = false;
-            currentSpeed = 0.0f;
-
-            // svi putnici se odvezuju i vracaju u normalno stanje
-            for (int i = 0; i < WAGON_SEGMENTS; ++i) {
-                passengerBuckled[i] = false;
-                passengerSick[i] = false;
-            }
-
-            // rezim uklanjanja putnika
-            isDisembarking = false;
-            for (int i = 0; i < WAGON_SEGMENTS; ++i) {
-                if (segmentHasPassenger[i]) {
-                    isDisembarking = true;
-                    break;
-                }
-            }
-        }
+    bool checkPassed = phaseMismatches == 0 && maxDs <= FLEET_TOLERANCE && maxDv <= FLEET_TOLERANCE;
+
+    std::cout << "Provera na " << checkCount << " vozova, " << steps << " koraka: najveca razlika s "
+        << maxDs << ", brzine " << maxDv << ", razlicitih faza " << phaseMismatches
+        << (checkPassed ? " - u redu" : " - NE SLAZE SE") << std::endl;
+    printFleetStats("CPU", cpu.stats(), checkCount);
+    printFleetStats("GPU", check.readStats(), checkCount);
+
+    // merenje: cela flota, sa GPU se cita samo FleetStats na kraju
+    FleetSimGpu fleet;
+    if (!fleet.init(track, trainCount, "fleet_step.comp", "fleet_stats.comp")) {
+        return endProgram("Flota ne staje na GPU.");
     }
+    glFinish();
+    auto gpuStart = std::chrono::steady_clock::now();
+    for (int k = 0; k < steps; ++k) fleet.step();
+    FleetStats stats = fleet.readStats();
+    double gpuSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - gpuStart).count();
+
+    std::cout << "Vozova: " << trainCount << ", koraka: " << steps
+        << ", GPU: " << gpuSeconds * 1e9 / (static_cast<double>(steps) * trainCount) << " ns"
+        << ", CPU updateState: " << cpuSeconds * 1e9 / (static_cast<double>(steps) * checkCount)
+        << " ns po vozu i koraku" << std::endl;
+    printFleetStats("Flota", stats, trainCount);
 
-    // racuna offset za svaki segment za ovaj frejm
-    for (int i = 0; i < WAGON_SEGMENTS; ++i) {
-        float sSeg = sHead - i * SEGMENT_SPACING;
-
-        float pathXSeg, pathYSeg;
-        getPointOnTrack(sSeg, pathXSeg, pathYSeg,
-            vertices, trackS, trackTotalLength);
-
-        segOffsetX[i] = pathXSeg - segmentCenterX[i];
-        segOffsetY[i] = pathYSeg - segmentCenterY;
-    }
+    glfwTerminate();
+    return checkPassed ? 0 : 1;
 }
 
-void handleMouseClick(
-    GLFWwindow* window,
-    bool& leftMouseWasPressed,
-    bool& isDisembarking,
-    int& passengersCount,
-    std::vector<bool>& segmentHasPassenger,
-    std::vector<bool>& passengerBuckled,
-    std::vector<bool>& passengerSick,
-    int PASSENGER_START_INDEX, //gde u vertices pocinju putnici
-    const std::vector<Vertex>& vertices,
-    const std::vector<float>& segOffsetX,
-    const std::vector<float>& segOffsetY
-)
+int main(int argc, char** argv)
 {
-    bool leftNow = (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS);
-    if (!(leftNow && !leftMouseWasPressed)) {
-        leftMouseWasPressed = leftNow;
-        return;
+    if (argc > 1 && std::strcmp(argv[1], "--simulate-day") == 0) {
+        return simulateDay(argc, argv);
     }
-
-    double mouseX, mouseY;
-    glfwGetCursorPos(window, &mouseX, &mouseY);
-
-    int fbWidth2, fbHeight2;
-    glfwGetFramebufferSize(window, &fbWidth2, &fbHeight2);
-
-    //konverzija u ndc
-    float xNdc = 2.0f * static_cast<float>(mouseX) / fbWidth2 - 1.0f;
-    float yNdc = -2.0f * static_cast<float>(mouseY) / fbHeight2 + 1.0f;
-
-    for (int i = 0; i < WAGON_SEGMENTS; ++i) {
-
-        if (isDisembarking) {
-            if (!segmentHasPassenger[i]) continue;
-        }
-        else {
-            if (!segmentHasPassenger[i] || passengerBuckled[i]) continue;
-        }
-
-        int pStart = PASSENGER_START_INDEX + i * PASSENGER_VERTEX_COUNT_PER_SEGMENT;
-        // svaki putnik  ima 4 verteksa
-        const Vertex& v0 = vertices[pStart + 0];
-        const Vertex& v1 = vertices[pStart + 1];
-        const Vertex& v2 = vertices[pStart + 2];
-        const Vertex& v3 = vertices[pStart + 3];
-
-        float minX = v0.x, maxX = v0.x;
-        float minY = v0.y, maxY = v0.y;
-
-        auto expandBounds = [&](const Vertex& v) {
-            if (v.x < minX) minX = v.x;
-            if (v.x > maxX) maxX = v.x;
-            if (v.y < minY) minY = v.y;
-            if (v.y > maxY) maxY = v.y;
-            };
-
-        expandBounds(v1);
-        expandBounds(v2);
-        expandBounds(v3);
-
-        minX += segOffsetX[i];
-        maxX += segOffsetX[i];
-        minY += segOffsetY[i];
-        maxY += segOffsetY[i];
-
-        if (xNdc >= minX && xNdc <= maxX &&
-            yNdc >= minY && yNdc <= maxY)
-        {
-            if (isDisembarking) {
-                // klik uklanja putnika
-                segmentHasPassenger[i] = false;
-                passengerBuckled[i] = false;
-                passengerSick[i] = false;
-                passengersCount--;
-
-                if (passengersCount <= 0) {
-                    passengersCount = 0;
-                    isDisembarking = false;
-                }
-            }
-            else {
-                // klik vezuje pojas
-                passengerBuckled[i] = true;
-            }
-            break;
-        }
+    if (argc > 1 && std::strcmp(argv[1], "--benchmark-train") == 0) {
+        return benchmarkTrain(argc, argv);
     }
-
-    leftMouseWasPressed = leftNow;//cuva za sledeci frejm da li je u ovom frejmu kliknut levi klik
-}
-
-void render(
-    GLuint basicShader,
-    GLuint VAO,
-    GLint uOffsetLocation,
-    GLint uUseTextureLocation,
-    GLint uTransparencyLocation,
-    int TRACK_VERTEX_COUNT,
-    int WAGON_START_INDEX,
-    int PASSENGER_START_INDEX,
-    int NAME_QUAD_START,
-    const std::vector<Vertex>& vertices,
-    const std::vector<bool>& segmentHasPassenger,
-    const std::vector<bool>& passengerBuckled,
-    const std::vector<bool>& passengerSick,
-    const std::vector<float>& segOffsetX,
-    const std::vector<float>& segOffsetY,
-    GLuint wagonTexture,
-    GLuint passengerTexture,
-    GLuint seatbeltTexture,
-    GLuint sickPassengerTexture,
-    GLuint nameTexture
-)
-{
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    glUseProgram(basicShader);
-    glBindVertexArray(VAO);
-
-    glUniform1i(uUseTextureLocation, GL_FALSE);
-    glUniform2f(uOffsetLocation, 0.0f, 0.0f);
-    glDrawArrays(GL_LINE_STRIP, 0, TRACK_VERTEX_COUNT);
-
-    for (int i = 0; i < WAGON_SEGMENTS; ++i) {
-        float offsetXSeg = segOffsetX[i];
-        float offsetYSeg = segOffsetY[i];
-        glUniform2f(uOffsetLocation, offsetXSeg, offsetYSeg);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, wagonTexture);
-        glUniform1i(uUseTextureLocation, GL_TRUE);
-
-        int carStartIndex = WAGON_START_INDEX + i * WAGON_VERTEX_COUNT_PER_SEGMENT;
-        glDrawArrays(GL_TRIANGLE_FAN, carStartIndex, WAGON_VERTEX_COUNT_PER_SEGMENT);
-
-        if (segmentHasPassenger[i]) {
-            unsigned int tex;
-
-            if (passengerSick[i] && sickPassengerTexture != 0) {
-                tex = sickPassengerTexture;
-            }
-            else {
-                tex = passengerBuckled[i] ? seatbeltTexture : passengerTexture;
-            }
-
-            glBindTexture(GL_TEXTURE_2D, tex);
-
-            int passengerStart =
-                PASSENGER_START_INDEX + i * PASSENGER_VERTEX_COUNT_PER_SEGMENT;
-            glDrawArrays(GL_TRIANGLE_FAN, passengerStart, PASSENGER_VERTEX_COUNT_PER_SEGMENT);
-        }
+    if (argc > 1 && std::strcmp(argv[1], "--benchmark-fleet") == 0) {
+        return benchmarkFleet(argc, argv);
     }
 
-    glUniform2f(uOffsetLocation, 0.0f, 0.0f);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, nameTexture);
-    glUniform1i(uUseTextureLocation, GL_TRUE);
-
-    glUniform1f(uTransparencyLocation, 1.0f);
-
-    glUniform1f(uTransparencyLocation, 0.5f);
-
-    glDrawArrays(GL_TRIANGLE_FAN, NAME_QUAD_START, 4);
-
-    glUniform1f(uTransparencyLocation, 1.0f);
-}
+    // --cars N: broj vagona u vozu
+    // --gpu-pick: klik se razresava ID pass-om na GPU umesto mrezom na CPU
+    // --no-persistent: instance kroz glBufferSubData i kad ima ARB_buffer_storage
+    int carCount = WAGON_SEGMENTS;
+    bool gpuPick = false;
+    bool persistentBuffers = true;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--cars") == 0 && i + 1 < argc) carCount = std::atoi(argv[i + 1]);
+        if (std::strcmp(argv[i], "--gpu-pick") == 0) gpuPick = true;
+        if (std::strcmp(argv[i], "--no-persistent") == 0) persistentBuffers = false;
+    }
 
-int main()
-{
     // Inicijalizacija GLFW
     glfwInit();
 
@@ -671,30 +452,70 @@ int main()
 
     unsigned int basicShader = createShader("basic.vert", "basic.frag");
 
-    int uOffsetLocation = glGetUniformLocation(basicShader, "uOffset");
-    int uUseTextureLocation = glGetUniformLocation(basicShader, "useTexture");
     int uTexLocation = glGetUniformLocation(basicShader, "uTex");
-    int uTransparencyLocation = glGetUniformLocation(basicShader, "uTransparency");
-
-    unsigned int wagonTexture = 0;
-    preprocessTexture(wagonTexture, "res/car.png");
-
-    unsigned int passengerTexture = 0;
-    preprocessTexture(passengerTexture, "res/passenger.png");
-
-    unsigned int seatbeltTexture = 0;
-    preprocessTexture(seatbeltTexture, "res/seatbelt.png");
+    int uSpritesLocation = glGetUniformLocation(basicShader, "uSprites");
+    bindUniformBlocks(basicShader);
+
+    // parametri frejma i prolaza idu u uniform blokove jednim upisom po frejmu
+    FrameUniforms frameUniforms = {};
+    for (int i = 0; i < 4; ++i) frameUniforms.viewProj[i * 4 + i] = 1.0f; // kamera jos ne postoji
+    frameUniforms.viewport[0] = static_cast<float>(fbWidth);
+    frameUniforms.viewport[1] = static_cast<float>(fbHeight);
+
+    PassUniforms passes[PASS_COUNT] = {};
+    passes[PASS_TRACK] = { { 0.7f, 0.7f, 0.7f, 1.0f }, GL_FALSE, 1.0f, 0, TRACK_WIDTH * fbHeight }; // siva staza
+    passes[PASS_TRAIN] = { { 1.0f, 1.0f, 1.0f, 1.0f }, GL_TRUE, 1.0f, 0, 0.0f };
+    passes[PASS_NAME] = { { 1.0f, 1.0f, 1.0f, 1.0f }, GL_TRUE, 0.5f, 0, 0.0f };
+    passes[PASS_PICK_CARS] = { { 1.0f, 1.0f, 1.0f, 1.0f }, GL_TRUE, 1.0f, 0, 0.0f };
+    passes[PASS_PICK_PASSENGERS] = { { 1.0f, 1.0f, 1.0f, 1.0f }, GL_TRUE, 1.0f, PICK_PASSENGER_BIT, 0.0f };
+
+    // sprajtovi voza redom kao LAYER_*
+    const char* spriteNames[SPRITE_LAYERS] = { "passenger", "seatbelt", "passenger_sick", "car" };
+    const char* spritePaths[SPRITE_LAYERS] = {
+        "res/passenger.png",
+        "res/seatbelt.png",
+        "res/passenger_sick.png",
+        "res/car.png"
+    };
+
+    // atlas-packer pravi res/atlas pri build-u, bez njega sprajtovi voza
+    // idu u niz tekstura, a ime u svoju teksturu
+    TextureAtlas atlas;
+    bool spriteAtlas = loadAtlas("res/atlas.txt", atlas);
+    int nameRect = findAtlasRect(atlas, "ime");
+    for (int layer = 0; layer < SPRITE_LAYERS && spriteAtlas; ++layer) {
+        int rect = findAtlasRect(atlas, spriteNames[layer]);
+        if (rect < 0) {
+            std::cout << "Atlas nema sprajt " << spriteNames[layer] << std::endl;
+            spriteAtlas = false;
+            break;
+        }
+        frameUniforms.spriteRects[layer][0] = atlas.rects[rect].u0;
+        frameUniforms.spriteRects[layer][1] = atlas.rects[rect].v0;
+        frameUniforms.spriteRects[layer][2] = atlas.rects[rect].u1;
+        frameUniforms.spriteRects[layer][3] = atlas.rects[rect].v1;
+    }
+    frameUniforms.useAtlas = spriteAtlas;
 
-    unsigned int sickPassengerTexture = 0;
-    preprocessTexture(sickPassengerTexture, "res/passenger_sick.png");
+    unsigned int spriteTexture = 0;
+    bool showSick = true;
+    if (spriteAtlas) {
+        spriteTexture = atlas.texture;
+    }
+    else {
+        bool spriteLoaded[SPRITE_LAYERS];
+        spriteTexture = loadImagesToTextureArray(spritePaths, SPRITE_LAYERS, spriteLoaded);
+        showSick = spriteLoaded[LAYER_SICK];
+    }
 
+    bool nameInAtlas = spriteAtlas && nameRect >= 0;
     unsigned int nameTexture = 0;
-    preprocessTexture(nameTexture, "res/ime.png");
+    if (nameInAtlas) nameTexture = atlas.texture;
+    else preprocessTexture(nameTexture, "res/ime.png");
 
     glUseProgram(basicShader);
     glUniform1i(uTexLocation, 0);
-
-    glUniform1f(uTransparencyLocation, 1.0f);
+    glUniform1i(uSpritesLocation, 1);
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -703,19 +524,23 @@ int main()
     std::vector<Vertex> vertices;
     std::vector<float>  trackS;
     float trackTotalLength = 0.0f;
+    std::vector<TrackRun> trackRuns; // lift, kocnice, lanser, stanica
 
     buildTrack(vertices, trackS, trackTotalLength);
+    TrainLayout train = makeTrainLayout(carCount, trackTotalLength);
+    buildTrackAttributes(vertices, trackS, train, trackRuns);
     int TRACK_VERTEX_COUNT = static_cast<int>(trackS.size());
 
+    // nominalna voznja se racuna jednom, hitno kocenje se integrise uzivo
+    RideTrajectory trajectory;
+    buildRideTrajectory(trackS, trackTotalLength, vertices, trackRuns, train, TRAJECTORY_STEP, trajectory);
+
     //Priprema voza
-    std::vector<float> segmentCenterX(WAGON_SEGMENTS);
-    float segmentCenterY = 0.0f;
     int   WAGON_START_INDEX = 0;
     int   PASSENGER_START_INDEX = 0;
     int   NAME_QUAD_START = 0;
 
-    buildTrain(vertices, segmentCenterX, segmentCenterY,
-        WAGON_START_INDEX, PASSENGER_START_INDEX);
+    buildTrain(vertices, train, WAGON_START_INDEX, PASSENGER_START_INDEX);
 
     NAME_QUAD_START = static_cast<int>(vertices.size());
 
@@ -724,183 +549,199 @@ int main()
     float y0 = 0.8f;
     float y1 = 0.98f;
 
-    float r = 1.0f, g = 1.0f, b = 1.0f;
-
-    vertices.push_back({ x0, y0, 0.0f, 0.0f, r, g, b }); // dole levo    
-    vertices.push_back({ x1, y0, 1.0f, 0.0f, r, g, b }); // dole desno    
-    vertices.push_back({ x1, y1, 1.0f, 1.0f, r, g, b }); // gore desno    
-    vertices.push_back({ x0, y1, 0.0f, 1.0f, r, g, b }); // gore levo
-
-    unsigned int VAO;
-    unsigned int VBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER,
-        vertices.size() * sizeof(Vertex),
-        vertices.data(),
-        GL_STATIC_DRAW);
-
-    glVertexAttribPointer(
-        0,
-        2,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Vertex),
-        (void*)0
-    );
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(
-        1,
-        2,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Vertex),
-        (void*)(2 * sizeof(float))
-    );
-    glEnableVertexAttribArray(1);
-
-    glVertexAttribPointer(
-        2,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(Vertex),
-        (void*)(4 * sizeof(float))
-    );
-    glEnableVertexAttribArray(2);
+    vertices.push_back({ x0, y0, 0.0f, 0.0f }); // dole levo    
+    vertices.push_back({ x1, y0, 1.0f, 0.0f }); // dole desno    
+    vertices.push_back({ x1, y1, 1.0f, 1.0f }); // gore desno    
+    vertices.push_back({ x0, y1, 0.0f, 1.0f }); // gore levo
+
+    if (nameInAtlas) mapQuadToAtlas(vertices, NAME_QUAD_START, 4, atlas.rects[nameRect]);
+
+    // na GPU staza ima samo polozaje (4 bajta po verteksu), a kvadrati voza
+    // i imena svoj tok sa tekstur koordinatama (8 bajtova), pa indeksi
+    // kvadrata krecu od QUAD_BASE; vertices ostaje za simulaciju
+    const int QUAD_BASE = WAGON_START_INDEX;
+    float positionScale = packedPositionScale(vertices);
+    frameUniforms.positionScale = positionScale;
+
+    std::vector<TrackPosition> trackPositions;
+    packTrackPositions(vertices, 0, TRACK_VERTEX_COUNT, positionScale, trackPositions);
+    std::vector<QuadVertex> quadVertices;
+    packQuadVertices(vertices, QUAD_BASE, static_cast<int>(vertices.size()) - QUAD_BASE, positionScale, quadVertices);
+
+    unsigned int trackVBO;
+    unsigned int quadVBO;
+    glGenBuffers(1, &trackVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, trackVBO);
+    glBufferData(GL_ARRAY_BUFFER, trackPositions.size() * sizeof(TrackPosition), trackPositions.data(), GL_STATIC_DRAW);
+    glGenBuffers(1, &quadVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, quadVertices.size() * sizeof(QuadVertex), quadVertices.data(), GL_STATIC_DRAW);
+
+    // kvadrati se crtaju kao indeksirani trouglovi iz zajednickog bafera
+    unsigned int quadIndices = createQuadIndexBuffer();
+
+    // trackS i polozaji staze ostaju na GPU, sejderi iz njih postavljaju
+    // vagone, pa se po frejmu salje samo glava voza
+    TrackTextures trackTextures;
+    if (!createTrackTextures(trackVBO, trackS, trackTextures)) {
+        return endProgram("Staza ne staje u bafer teksturu.");
+    }
+    frameUniforms.trainSpacing = train.spacing;
+    frameUniforms.trackLength = trackTotalLength;
+    frameUniforms.trackPoints = TRACK_VERTEX_COUNT;
+    setTrackSamplers(basicShader);
+
+    // staza je debela linija iz track sejdera, ili GL_LINE_STRIP ako on ne radi
+    TrackRenderer trackRenderer;
+    trackRenderer.init(trackVBO, TRACK_VERTEX_COUNT, "track.vert", "track.frag");
+
+    unsigned int quadVAO;
+    glGenVertexArrays(1, &quadVAO);
+    glBindVertexArray(quadVAO);
+    setQuadVertexAttributes(quadVBO, quadIndices);
+
+    // VAO za vagone i putnike: isti kvadrati, indeks vagona po instanci na
+    // lokaciji 4 i sloj teksture na lokaciji 5. Instance vagona se ne menjaju,
+    // a putnici se pisu svaki frejm u deo bafera koji GPU vise ne cita
+    std::vector<float> carInstanceData;
+    for (int i = 0; i < train.carCount; ++i) {
+        carInstanceData.push_back(static_cast<float>(i));
+        carInstanceData.push_back(static_cast<float>(LAYER_CAR));
+    }
+    unsigned int carInstances;
+    glGenBuffers(1, &carInstances);
+    glBindBuffer(GL_ARRAY_BUFFER, carInstances);
+    glBufferData(GL_ARRAY_BUFFER, carInstanceData.size() * sizeof(float), carInstanceData.data(), GL_STATIC_DRAW);
+
+    unsigned int trainVAO;
+    StreamBuffer instances;
+    instances.init(train.carCount * INSTANCE_FLOATS * sizeof(float), persistentBuffers);
+    UniformBlocks uniformBlocks;
+    uniformBlocks.init(persistentBuffers);
+    glGenVertexArrays(1, &trainVAO);
+
+    glBindVertexArray(trainVAO);
+    setQuadVertexAttributes(quadVBO, quadIndices);
+
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, INSTANCE_FLOATS * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(4);
+    glVertexAttribDivisor(4, 1);
+    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, INSTANCE_FLOATS * sizeof(float), (void*)sizeof(float));
+    glEnableVertexAttribArray(5);
+    glVertexAttribDivisor(5, 1);
+
+    glBindVertexArray(0);
+
+    // ime nema niz na lokaciji 5, pa je sloj -1, tj. nije na stazi i
+    // tekstura je iz uTex
+    glVertexAttrib1f(5, -1.0f);
 
     glClearColor(0.3f, 0.1f, 0.6f, 1.0f);
 
-    double lastTime = glfwGetTime();
-
-    float currentSpeed = 0.0f;
-
-    float sHead = START_S_HEAD;
-    bool  isRunning = false;
-    bool  isReturning = false;
-
-    bool isWaitingBeforeReturn = false;
-    bool isDisembarking = false;
-
-    double waitTimer = 0.0;
-
-    // hitna situacija
-    bool  isEmergencyDecel = false;
-    bool  isEmergencyWaiting = false;
-    double emergencyWaitTimer = 0.0;
-    bool  returnFromEmergency = false;
-    int   sickPassengerIndex = -1;
+    // tastatura i mis stizu kroz callback-ove i idu simulacionoj niti
+    InputQueue inputQueue;
+    std::deque<InputEvent> pickClicks; // klikovi za GPU picking
+    InputTargets inputTargets;
+    inputTargets.queue = &inputQueue;
 
-    //da li je odredjeni segment popunjen putnikom
-    std::vector<bool> segmentHasPassenger(WAGON_SEGMENTS, false);
-    int passengersCount = 0;
-
-    // da li je putnik vezan pojasom
-    std::vector<bool> passengerBuckled(WAGON_SEGMENTS, false);
-
-    // da li je putniku pozlilo
-    std::vector<bool> passengerSick(WAGON_SEGMENTS, false);
-
-    bool spaceWasPressed = false;
-    bool leftMouseWasPressed = false;
-    bool enterWasPressed = false;
-
-    // offseti segmenta za svaki frejm
-    std::vector<float> segOffsetX(WAGON_SEGMENTS, 0.0f);
-    std::vector<float> segOffsetY(WAGON_SEGMENTS, 0.0f);
+    GpuPicker picker;
+    if (gpuPick && picker.init(fbWidth, fbHeight, "pick.vert", "pick.frag")) {
+        inputTargets.clicks = &pickClicks;
+    }
+    installInputCallbacks(window, &inputTargets);
+
+    InstancedDraw trainDraws[MAX_TRAIN_DRAWS];
+    int trainDrawCount = 0;
+
+    // kasnjenje od ulaza do prikaza, izvestaj na izlazu
+    LatencyTracker latency;
+    AppliedInputQueue appliedInputs;
+    std::deque<AppliedInput> waitingInputs; // primljeni, ali jos nisu u prikazanom snimku
+
+    // snimci stanja simulacija -> render
+    // prvi snimak je voz u stanici, dok simulacija ne objavi svoj
+    RideState initialRide(train);
+    RideSnapshot initialSnapshot;
+    initialSnapshot.sHead = initialRide.sHead;
+    initialSnapshot.segmentHasPassenger = initialRide.segmentHasPassenger;
+    initialSnapshot.passengerBuckled = initialRide.passengerBuckled;
+    initialSnapshot.passengerSick = initialRide.passengerSick;
+    TripleBuffer<RideSnapshot> snapshots(initialSnapshot);
+
+    SimContext simContext;
+    simContext.vertices = &vertices;
+    simContext.trackS = &trackS;
+    simContext.trackRuns = &trackRuns;
+    simContext.trajectory = &trajectory;
+    simContext.trackTotalLength = trackTotalLength;
+    simContext.train = train;
+    simContext.passengerStartIndex = PASSENGER_START_INDEX;
+    simContext.inputQueue = &inputQueue;
+    simContext.snapshots = &snapshots;
+    simContext.appliedInputs = &appliedInputs;
+
+    // render i ID pass menjaju stanje samo kroz kes
+    GlStateCache glState;
+
+    // simulacija ide svojim tempom, vsync je ne zadrzava
+    std::thread simThread(runSimulationThread, &simContext);
 
     while (!glfwWindowShouldClose(window))
     {
 
         double frameStart = glfwGetTime();
-        double deltaTime = frameStart - lastTime;
-        lastTime = frameStart;
-
-        handleKeyboardInput(
-            window,
-            spaceWasPressed,
-            enterWasPressed,
-            isRunning,
-            isReturning,
-            isEmergencyDecel,
-            isEmergencyWaiting,
-            isDisembarking,
-            passengersCount,
-            segmentHasPassenger,
-            passengerBuckled,
-            passengerSick,
-            sickPassengerIndex,
-            returnFromEmergency
-        );
 
-        updateState(
-            deltaTime,
-            sHead,
-            currentSpeed,
-            isRunning,
-            isReturning,
-            isWaitingBeforeReturn,
-            isDisembarking,
-            waitTimer,
-            isEmergencyDecel,
-            isEmergencyWaiting,
-            emergencyWaitTimer,
-            returnFromEmergency,
-            passengerBuckled,
-            passengerSick,
-            trackS,
-            trackTotalLength,
-            vertices,
-            segmentCenterX,
-            segmentCenterY,
-            segOffsetX,
-            segOffsetY,
-            segmentHasPassenger,
-            passengersCount
-        );
+        latency.pollPresented(frameStart);
+        if (inputTargets.clicks) picker.poll(inputQueue);
 
-        handleMouseClick(
-            window,
-            leftMouseWasPressed,
-            isDisembarking,
-            passengersCount,
-            segmentHasPassenger,
-            passengerBuckled,
-            passengerSick,
-            PASSENGER_START_INDEX,
-            vertices,
-            segOffsetX,
-            segOffsetY
-        );
+        snapshots.update();
+        const RideSnapshot& snapshot = snapshots.readBuffer();
+
+        // ulazi cija se promena vidi u ovom snimku ulaze u ovaj frejm
+        AppliedInput applied;
+        while (appliedInputs.pop(applied)) waitingInputs.push_back(applied);
+        while (!waitingInputs.empty() && waitingInputs.front().version <= snapshot.version) {
+            latency.onInputApplied(waitingInputs.front().kind, waitingInputs.front().inputTime);
+            waitingInputs.pop_front();
+        }
+
+        frameUniforms.trainSHead = snapshot.sHead;
+        uniformBlocks.upload(glState, frameUniforms, passes);
 
         render(
+            glState,
             basicShader,
-            VAO,
-            uOffsetLocation,
-            uUseTextureLocation,
-            uTransparencyLocation,
-            TRACK_VERTEX_COUNT,
-            WAGON_START_INDEX,
-            PASSENGER_START_INDEX,
-            NAME_QUAD_START,
-            vertices,
-            segmentHasPassenger,
-            passengerBuckled,
-            passengerSick,
-            segOffsetX,
-            segOffsetY,
-            wagonTexture,
-            passengerTexture,
-            seatbeltTexture,
-            sickPassengerTexture,
-            nameTexture
+            trackRenderer,
+            quadVAO,
+            trainVAO,
+            trackTextures,
+            carInstances,
+            instances,
+            uniformBlocks,
+            WAGON_START_INDEX - QUAD_BASE,
+            PASSENGER_START_INDEX - QUAD_BASE,
+            NAME_QUAD_START - QUAD_BASE,
+            snapshot.segmentHasPassenger,
+            snapshot.passengerBuckled,
+            snapshot.passengerSick,
+            train.carCount,
+            spriteTexture,
+            spriteAtlas,
+            showSick,
+            nameTexture,
+            trainDraws,
+            trainDrawCount
         );
 
+        if (inputTargets.clicks) {
+            picker.renderIds(glState, pickClicks, trainVAO, INSTANCE_FLOATS,
+                spriteTexture, spriteAtlas, uniformBlocks, trainDraws, trainDrawCount);
+        }
+        instances.endFrame();
+        uniformBlocks.endFrame();
+
         glfwSwapBuffers(window);
+        latency.onFrameSubmitted();
         glfwPollEvents();
 
         double frameEnd = glfwGetTime();
@@ -913,6 +754,15 @@ int main()
         }
     }
 
+    simContext.stop.store(true);
+    simThread.join();
+
+    latency.printReport();
+    glState.printReport();
+    if (instances.persistent()) {
+        std::cout << "Instance u trajno mapiranom baferu, cekanja na GPU: " << instances.stalls() << std::endl;
+    }
+
     glfwTerminate();
     return 0;
 }
@@ -0,0 +1,97 @@
+#include "PackedVertex.h"
+
+#include <algorithm>
+#include <cmath>
+
+float packedPositionScale(const std::vector<Vertex>& vertices)
+{
+    float extent = 1.0f;
+    for (const Vertex& v : vertices) {
+        extent = std::max(extent, std::max(std::fabs(v.x), std::fabs(v.y)));
+    }
+    return extent / 32767.0f;
+}
+
+static GLshort packPosition(float value, float positionScale)
+{
+    float steps = std::round(value / positionScale);
+    return static_cast<GLshort>(std::max(-32767.0f, std::min(steps, 32767.0f)));
+}
+
+static GLushort packTexCoord(float value)
+{
+    float steps = std::round(value * 65535.0f);
+    return static_cast<GLushort>(std::max(0.0f, std::min(steps, 65535.0f)));
+}
+
+void packTrackPositions(const std::vector<Vertex>& vertices, int first, int count,
+    float positionScale, std::vector<TrackPosition>& out)
+{
+    for (int i = first; i < first + count; ++i) {
+        const Vertex& v = vertices[i];
+        out.push_back({ packPosition(v.x, positionScale), packPosition(v.y, positionScale) });
+    }
+}
+
+void packQuadVertices(const std::vector<Vertex>& vertices, int first, int count,
+    float positionScale, std::vector<QuadVertex>& out)
+{
+    for (int i = first; i < first + count; ++i) {
+        const Vertex& v = vertices[i];
+        out.push_back({ packPosition(v.x, positionScale), packPosition(v.y, positionScale),
+            packTexCoord(v.u), packTexCoord(v.v) });
+    }
+}
+
+GLuint createQuadIndexBuffer()
+{
+    std::vector<GLushort> indices;
+    indices.reserve(QUAD_BATCH_MAX * QUAD_INDICES);
+    for (int q = 0; q < QUAD_BATCH_MAX; ++q) {
+        GLushort v = static_cast<GLushort>(q * 4);
+        const GLushort quad[QUAD_INDICES] = { v, GLushort(v + 1), GLushort(v + 2), v, GLushort(v + 2), GLushort(v + 3) };
+        indices.insert(indices.end(), quad, quad + QUAD_INDICES);
+    }
+
+    // vezivanje za GL_ELEMENT_ARRAY_BUFFER menja vezani VAO, pa se puni kroz
+    // GL_COPY_WRITE_BUFFER
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return buffer;
+}
+
+void setTrackPositionAttributes(GLuint buffer)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, sizeof(TrackPosition), (void*)0);
+    glEnableVertexAttribArray(0);
+}
+
+void setQuadVertexAttributes(GLuint buffer, GLuint indexBuffer)
+{
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, sizeof(QuadVertex), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(QuadVertex), (void*)(2 * sizeof(GLshort)));
+    glEnableVertexAttribArray(1);
+}
+
+void drawQuads(int firstVertex, int quadCount)
+{
+    // veci nizovi idu u delovima od QUAD_BATCH_MAX
+    for (int done = 0; done < quadCount; done += QUAD_BATCH_MAX) {
+        int count = std::min(quadCount - done, QUAD_BATCH_MAX);
+        glDrawElementsBaseVertex(GL_TRIANGLES, count * QUAD_INDICES, GL_UNSIGNED_SHORT, (void*)0,
+            firstVertex + done * 4);
+    }
+}
+
+void drawQuadInstanced(int firstVertex, int instanceCount)
+{
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, QUAD_INDICES, GL_UNSIGNED_SHORT, (void*)0,
+        instanceCount, firstVertex);
+}
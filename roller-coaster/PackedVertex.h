@@ -0,0 +1,52 @@
+#pragma once
+#include <GL/glew.h>
+
+#include "Ride.h"
+
+#include <vector>
+
+// TrackPosition
+// Verteks staze na GPU: samo polozaj, 16-bitni celi brojevi koje sejder
+// mnozi sa uPositionScale. Staza nema teksturu, boja joj je u Pass bloku.
+struct TrackPosition {
+    GLshort x, y;
+};
+
+// QuadVertex
+// Verteks kvadrata (vagon, putnik, ime): polozaj kao TrackPosition i tekstur
+// koordinate kao normalizovani unsigned short.
+struct QuadVertex {
+    GLshort x, y;
+    GLushort u, v;
+};
+
+// korak polozaja: najveci |x| ili |y| (bar 1) podeljen sa 32767, pa svi
+// verteksi staju u GLshort
+float packedPositionScale(const std::vector<Vertex>& vertices);
+
+// count verteksa od first iz vertices, dodaju se na kraj out
+void packTrackPositions(const std::vector<Vertex>& vertices, int first, int count,
+    float positionScale, std::vector<TrackPosition>& out);
+void packQuadVertices(const std::vector<Vertex>& vertices, int first, int count,
+    float positionScale, std::vector<QuadVertex>& out);
+
+// najvise kvadrata u jednom pozivu, indeksi su GLushort
+const int QUAD_BATCH_MAX = 16384;
+const int QUAD_INDICES = 6;
+
+// zajednicki staticki indeks bafer: kvadrat q su trouglovi (4q, 4q+1, 4q+2)
+// i (4q, 4q+2, 4q+3), tj. dole levo, dole desno, gore desno, gore levo kao u
+// buildTrain. Poziv bira kvadrate preko base vertex-a, pa isti bafer
+// sluzi za svaki niz kvadrata u QuadVertex toku.
+GLuint createQuadIndexBuffer();
+
+// nizovi na lokacijama 0 (polozaj) i 1 (tekstura) za vezani VAO,
+// buffer sadrzi TrackPosition odnosno QuadVertex od pocetka, a indexBuffer
+// iz createQuadIndexBuffer ostaje vezan uz VAO
+void setTrackPositionAttributes(GLuint buffer);
+void setQuadVertexAttributes(GLuint buffer, GLuint indexBuffer);
+
+// quadCount uzastopnih kvadrata od verteksa firstVertex, jednim pozivom
+void drawQuads(int firstVertex, int quadCount);
+// isti kvadrat za instanceCount instanci
+void drawQuadInstanced(int firstVertex, int instanceCount);
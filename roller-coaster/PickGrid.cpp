@@ -0,0 +1,79 @@
+#include "PickGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+PickGrid::PickGrid(int carCount, float minX, float minY, float maxX, float maxY)
+    : boxMinX(minX), boxMinY(minY), boxMaxX(maxX), boxMaxY(maxY),
+    next(carCount, -1), prev(carCount, -1), carCell(carCount, -1)
+{
+    cellSize = std::max(std::max(boxMaxX - boxMinX, boxMaxY - boxMinY), 2.0f / PICK_GRID_MAX_CELLS);
+    cellsPerAxis = std::min(PICK_GRID_MAX_CELLS, static_cast<int>(std::ceil(2.0f / cellSize)));
+    head.assign(cellsPerAxis * cellsPerAxis, -1);
+}
+
+// celija po jednoj osi, tacke van ekrana idu u ivicne celije
+int PickGrid::cellCoord(float v) const
+{
+    int c = static_cast<int>(std::floor((v + 1.0f) / cellSize));
+    return std::max(0, std::min(c, cellsPerAxis - 1));
+}
+
+void PickGrid::unlink(int car)
+{
+    int cell = carCell[car];
+    if (prev[car] >= 0) next[prev[car]] = next[car];
+    else head[cell] = next[car];
+    if (next[car] >= 0) prev[next[car]] = prev[car];
+}
+
+void PickGrid::link(int car, int cell)
+{
+    carCell[car] = cell;
+    prev[car] = -1;
+    next[car] = head[cell];
+    if (head[cell] >= 0) prev[head[cell]] = car;
+    head[cell] = car;
+}
+
+void PickGrid::update(const float* offsetX, const float* offsetY)
+{
+    const int carCount = static_cast<int>(carCell.size());
+    for (int car = 0; car < carCount; ++car) {
+        int cell = cellCoord(offsetY[car]) * cellsPerAxis + cellCoord(offsetX[car]);
+        if (cell == carCell[car]) continue;
+
+        if (carCell[car] >= 0) unlink(car);
+        link(car, cell);
+    }
+}
+
+int PickGrid::pick(float x, float y,
+    const float* offsetX,
+    const float* offsetY,
+    const SeatMask& candidates) const
+{
+    // (x, y) je u kvadratu vagona ako je offset u [x - boxMax, x - boxMin]
+    int cx0 = cellCoord(x - boxMaxX);
+    int cx1 = cellCoord(x - boxMinX);
+    int cy0 = cellCoord(y - boxMaxY);
+    int cy1 = cellCoord(y - boxMinY);
+
+    int best = -1;
+    for (int cy = cy0; cy <= cy1; ++cy) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            for (int car = head[cy * cellsPerAxis + cx]; car >= 0; car = next[car]) {
+                if (best >= 0 && car > best) continue;
+                if (!candidates.test(car)) continue;
+
+                float localX = x - offsetX[car];
+                float localY = y - offsetY[car];
+                if (localX >= boxMinX && localX <= boxMaxX &&
+                    localY >= boxMinY && localY <= boxMaxY) {
+                    best = car;
+                }
+            }
+        }
+    }
+    return best;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "SeatMask.h"
+
+#include <vector>
+
+// najvise celija po osi, za vrlo male vagone celija sadrzi vise njih
+const int PICK_GRID_MAX_CELLS = 256;
+
+// PickGrid
+// Uniformna mreza preko ekrana [-1, 1] x [-1, 1] za trazenje putnika pod
+// kursorom. Svi putnici imaju isti kvadrat (box) pomeren za offset vagona,
+// pa se vagon pamti u celiji svog offseta, a celija je bar velika kao
+// kvadrat. Klik zato gleda najvise 2 x 2 celije, bez obzira na broj vagona.
+// Svaka celija je dvostruko povezana lista vagona, pa se vagon koji predje
+// u drugu celiju samo prevezuje.
+class PickGrid {
+public:
+    PickGrid(int carCount, float minX, float minY, float maxX, float maxY);
+
+    // posle svakog pomeranja vagona, prevezuje samo one koji su promenili celiju
+    void update(const float* offsetX, const float* offsetY);
+
+    // najmanji indeks vagona iz candidates ciji kvadrat sadrzi (x, y), -1 ako ga nema
+    int pick(float x, float y,
+        const float* offsetX,
+        const float* offsetY,
+        const SeatMask& candidates) const;
+
+private:
+    int cellCoord(float v) const;
+    void unlink(int car);
+    void link(int car, int cell);
+
+    float boxMinX, boxMinY, boxMaxX, boxMaxY;
+    float cellSize;
+    int cellsPerAxis;
+
+    std::vector<int> head;     // prvi vagon u celiji, -1 ako je prazna
+    std::vector<int> next;     // po vagonu
+    std::vector<int> prev;
+    std::vector<int> carCell;  // -1 dok vagon nije upisan
+};
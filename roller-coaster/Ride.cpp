@@ -0,0 +1,609 @@
+#include "Ride.h"
+#include "TimerWheel.h"
+
+#include <cmath>
+#include <algorithm>
+
+// buildTrack
+// Popunjava:
+// - vertices: tacke staze
+// - trackS:   kumulativne duzine duz staze
+// - trackTotalLength: ukupna duzina staze
+void buildTrack(std::vector<Vertex>& vertices,
+    std::vector<float>& trackS, // trackS[i] je duzina staze do verteksa i
+    float& trackTotalLength)
+{
+    vertices.clear();
+    vertices.reserve(NUM_TRACK_POINTS);
+
+    for (int i = 0; i < NUM_TRACK_POINTS; ++i) {
+        float t = i / float(NUM_TRACK_POINTS - 1);
+
+        float x = -0.9f + t * 1.8f;        // x se linijski menja od -0.9 do 0.9
+        float bigHill = std::sin(3.14159f * (t + 0.1f));                 // 1 veliko brdo
+        float midHill = 0.6f * std::sin(3.0f * 3.14159f * (t - 0.15f));  // 3 srednja
+        float smallWiggle = 0.3f * std::sin(8.0f * 3.14159f * t);           // sitne neravnine
+
+        float hills = bigHill + midHill + smallWiggle;
+        float yBase = -0.45f;
+        float yAmp = 0.42f;
+
+        float y = yBase + yAmp * hills;
+        vertices.push_back({ x, y, 0.0f, 0.0f });
+    }
+
+    int trackVertexCount = NUM_TRACK_POINTS;
+
+    // trackS[i] zna razdaljinu od pocetka do verteksa i.
+    trackS.resize(trackVertexCount);
+    trackS[0] = 0.0f;
+    for (int i = 1; i < trackVertexCount; ++i) {
+        float dx = vertices[i].x - vertices[i - 1].x;
+        float dy = vertices[i].y - vertices[i - 1].y;
+        float dist = std::sqrt(dx * dx + dy * dy);
+        trackS[i] = trackS[i - 1] + dist;
+    }
+    // ukupna duzina staze je kumulativna duzina do poslednjeg verteksa
+    trackTotalLength = trackS[trackVertexCount - 1];
+}
+
+// makeTrainLayout
+TrainLayout makeTrainLayout(int carCount, float trackTotalLength)
+{
+    TrainLayout train;
+    train.carCount = std::max(1, std::min(carCount, MAX_WAGON_SEGMENTS));
+
+    // razmak je isti kao za kratak voz dok god voz staje na svoj deo staze
+    float spacing = WAGON_SEGMENT_SIZE + WAGON_GAP;
+    float maxLength = MAX_TRAIN_TRACK_FRACTION * trackTotalLength;
+    if (train.carCount * spacing > maxLength) spacing = maxLength / train.carCount;
+
+    train.spacing = spacing;
+    train.carSize = spacing * WAGON_SEGMENT_SIZE / (WAGON_SEGMENT_SIZE + WAGON_GAP);
+    train.startSHead = (train.carCount - 1) * spacing;
+    return train;
+}
+
+// buildTrain
+void buildTrain(std::vector<Vertex>& vertices,
+    const TrainLayout& train,
+    int& wagonStartIndex, //startni segment u vertices
+    int& passengerStartIndex)
+{
+    // vagon stoji na tacki staze, dno mu je na y = 0
+    float size = train.carSize;
+    float x0 = -size / 2.0f;
+    float x1 = size / 2.0f;
+
+    wagonStartIndex = static_cast<int>(vertices.size());
+    {
+        vertices.push_back({ x0, 0.0f, 0.0f, 0.0f }); // dole levo
+        vertices.push_back({ x1, 0.0f, 1.0f, 0.0f }); // dole desno
+        vertices.push_back({ x1, size, 1.0f, 1.0f }); // gore desno
+        vertices.push_back({ x0, size, 0.0f, 1.0f }); // gore levo
+    }
+
+    //kvadrat za putnika
+    passengerStartIndex = static_cast<int>(vertices.size());
+    {
+        //margine za uvlacenje teksture putnika unutra, srazmerne vagonu
+        float marginX = 0.15f * size;
+        float marginYBottom = 0.1f * size;
+        float marginYTop = 0.2f * size;
+
+        float passengerYOffset = 0.4f * size;
+
+        float px0 = x0 + marginX;
+        float px1 = x1 - marginX;
+        float py0 = marginYBottom + passengerYOffset;
+        float py1 = size - marginYTop + passengerYOffset;
+
+        vertices.push_back({ px0, py0, 0.0f, 0.0f }); // dole levo
+        vertices.push_back({ px1, py0, 1.0f, 0.0f }); // dole desno
+        vertices.push_back({ px1, py1, 1.0f, 1.0f }); // gore desno
+        vertices.push_back({ px0, py1, 0.0f, 1.0f }); // gore levo
+    }
+}
+
+// buildTrackAttributes
+// Stanica je ispod voza koji ceka, lift vodi do prvog vrha,
+// lanser je na dnu najdublje doline, a poslednja desetina staze je kocnica.
+void buildTrackAttributes(const std::vector<Vertex>& vertices,
+    const std::vector<float>& trackS,
+    const TrainLayout& train,
+    std::vector<TrackRun>& trackRuns)
+{
+    const int segmentCount = static_cast<int>(trackS.size()) - 1;
+    const float totalLength = trackS[segmentCount];
+
+    std::vector<SegmentType> types(segmentCount, SegmentType::Normal);
+    std::vector<float> speeds(segmentCount, 0.0f);
+
+    // stanica: do malo ispred glave voza
+    int stationEnd = 0;
+    while (stationEnd < segmentCount && trackS[stationEnd] < train.startSHead + train.carSize) {
+        types[stationEnd] = SegmentType::Station;
+        speeds[stationEnd] = STATION_EXIT_SPEED;
+        ++stationEnd;
+    }
+
+    // lift: od stanice do prvog vrha
+    int liftEnd = stationEnd;
+    while (liftEnd < segmentCount && vertices[liftEnd + 1].y >= vertices[liftEnd].y) {
+        types[liftEnd] = SegmentType::Lift;
+        speeds[liftEnd] = LIFT_SPEED;
+        ++liftEnd;
+    }
+
+    // kocnica: poslednja desetina staze
+    int brakeStart = segmentCount;
+    while (brakeStart > liftEnd && trackS[brakeStart - 1] > 0.9f * totalLength) {
+        --brakeStart;
+        types[brakeStart] = SegmentType::Brake;
+        speeds[brakeStart] = BRAKE_SPEED;
+    }
+
+    // lanser: od najnize tacke izmedju lifta i kocnice nekoliko segmenata uzbrdo
+    int valley = -1;
+    for (int i = liftEnd; i < brakeStart; ++i) {
+        if (valley < 0 || vertices[i].y < vertices[valley].y) valley = i;
+    }
+    for (int i = valley; valley >= 0 && i < std::min(valley + 8, brakeStart); ++i) {
+        types[i] = SegmentType::Launch;
+        speeds[i] = LAUNCH_SPEED;
+    }
+
+    // sabija u nizove istog tipa
+    trackRuns.clear();
+    for (int i = 0; i < segmentCount; ++i) {
+        if (trackRuns.empty() || trackRuns.back().type != types[i]
+            || trackRuns.back().targetSpeed != speeds[i]) {
+            trackRuns.push_back({ i, i + 1, types[i], speeds[i] });
+        }
+        else {
+            trackRuns.back().endSegment = i + 1;
+        }
+    }
+}
+
+void seekTrackCursor(TrackCursor& cursor,
+    float s,
+    const std::vector<float>& trackS,
+    const std::vector<TrackRun>& trackRuns)
+{
+    const int lastSegment = static_cast<int>(trackS.size()) - 2;
+
+    while (cursor.segment < lastSegment && trackS[cursor.segment + 1] < s) {
+        ++cursor.segment;
+    }
+    while (cursor.segment > 0 && trackS[cursor.segment] > s) {
+        --cursor.segment;
+    }
+
+    if (trackRuns.empty()) return;
+    while (cursor.segment >= trackRuns[cursor.run].endSegment) ++cursor.run;
+    while (cursor.segment < trackRuns[cursor.run].firstSegment) --cursor.run;
+}
+
+// getPointOnTrack
+// Za datu duzinu s (udaljenost duz staze od pocetka) vraca tacku (x,y) na sinama
+void getPointOnTrack(float s, //duzina staze
+    TrackCursor& cursor, // segment iz prethodnog poziva
+    float& outX,  // povratne koordinate x i y
+    float& outY,
+    const std::vector<Vertex>& vertices,
+    const std::vector<float>& trackS,
+    const std::vector<TrackRun>& trackRuns,
+    float trackTotalLength)
+{
+    if (s < 0.0f)            s = 0.0f;
+    if (s > trackTotalLength) s = trackTotalLength;
+
+    //pomera se od proslog segmenta do segmenta u kome se nalazi duzina s.
+    seekTrackCursor(cursor, s, trackS, trackRuns);
+    int i = cursor.segment;
+
+    // duzina segmenta [i, i+1].
+    float segLen = trackS[i + 1] - trackS[i];
+    // razdaljina od pocetka segmenta do s
+    float tLocal = (segLen > 0.0f) ? (s - trackS[i]) / segLen : 0.0f;
+
+    // Koordinate krajeva segmenta
+    float x0 = vertices[i].x;
+    float y0 = vertices[i].y;
+    float x1 = vertices[i + 1].x;
+    float y1 = vertices[i + 1].y;
+
+    // pomeri se tLocal procenata unutar segmenta
+    outX = x0 + tLocal * (x1 - x0);
+    outY = y0 + tLocal * (y1 - y0);
+}
+
+StopPrediction predictEmergencyStop(float s, float v, float trackTotalLength)
+{
+    StopPrediction prediction = { s, 0.0 };
+    if (v <= EMERGENCY_STOP_SPEED) return prediction;
+
+    // v(t) = v - a t,  s(t) = s + v t - a t^2 / 2
+    prediction.timeToStop = (v - EMERGENCY_STOP_SPEED) / EMERGENCY_DECEL;
+    float distance = (v * v - EMERGENCY_STOP_SPEED * EMERGENCY_STOP_SPEED) / (2.0f * EMERGENCY_DECEL);
+    prediction.sStop = std::min(s + distance, trackTotalLength);
+    return prediction;
+}
+
+void buildRideTrajectory(const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>& trackRuns,
+    const TrainLayout& train,
+    double step,
+    RideTrajectory& trajectory)
+{
+    RideTrajectory live;
+    TimerWheel timers;
+    RideState ride(train);
+    ride.phase = RidePhase::Running;
+
+    trajectory.step = step;
+    trajectory.s.assign(1, ride.sHead);
+    trajectory.v.assign(1, ride.currentSpeed);
+
+    while (ride.phase == RidePhase::Running) {
+        float lastSpeed = ride.currentSpeed;
+        updateState(step, ride, trackS, trackTotalLength, vertices, trackRuns, live, timers, 0);
+        trajectory.s.push_back(ride.sHead);
+        // na kraju ReachedEnd nulira brzinu, pamti se brzina dolaska
+        trajectory.v.push_back(ride.phase == RidePhase::Running ? ride.currentSpeed : lastSpeed);
+    }
+    trajectory.duration = (trajectory.s.size() - 1) * step;
+}
+
+void sampleRideTrajectory(const RideTrajectory& trajectory, double t, float& outS, float& outV)
+{
+    const int last = static_cast<int>(trajectory.s.size()) - 1;
+    double pos = t / trajectory.step;
+    if (pos <= 0.0) pos = 0.0;
+
+    int k = static_cast<int>(pos);
+    if (k >= last) {
+        outS = trajectory.s[last];
+        outV = trajectory.v[last];
+        return;
+    }
+
+    float frac = static_cast<float>(pos - k);
+    outS = trajectory.s[k] + frac * (trajectory.s[k + 1] - trajectory.s[k]);
+    outV = trajectory.v[k] + frac * (trajectory.v[k + 1] - trajectory.v[k]);
+}
+
+struct RideEventArgs {
+    int seat;
+    float trackTotalLength;
+};
+
+typedef bool (*RideGuard)(const RideState& ride, const RideEventArgs& args);
+// akcija moze da vrati sledeci dogadjaj koji se odmah salje, ili RideEvent::None
+typedef RideEvent (*RideAction)(RideState& ride, const RideEventArgs& args);
+
+struct RideTransition {
+    RidePhase from;
+    RideEvent event;
+    RidePhase to;
+    RideGuard guard;   // nullptr -> uvek
+    RideAction action; // nullptr -> samo promena faze
+};
+
+static bool seatInRange(const RideState& ride, const RideEventArgs& args)
+{
+    return args.seat >= 0 && args.seat < ride.train.carCount;
+}
+
+static bool canAddPassenger(const RideState& ride, const RideEventArgs&)
+{
+    return ride.segmentHasPassenger.firstClear(ride.train.carCount) >= 0;
+}
+
+// putnik seda na prvo slobodno sediste
+static RideEvent doAddPassenger(RideState& ride, const RideEventArgs&)
+{
+    ride.segmentHasPassenger.set(ride.segmentHasPassenger.firstClear(ride.train.carCount));
+    return RideEvent::None;
+}
+
+static bool canBuckle(const RideState& ride, const RideEventArgs& args)
+{
+    return seatInRange(ride, args) && ride.segmentHasPassenger.test(args.seat) && !ride.passengerBuckled.test(args.seat);
+}
+
+static RideEvent doBuckle(RideState& ride, const RideEventArgs& args)
+{
+    ride.passengerBuckled.set(args.seat);
+    return RideEvent::None;
+}
+
+// ENTER pokrece voz samo ako su svi putnici vezani
+static bool canDispatch(const RideState& ride, const RideEventArgs&)
+{
+    return !ride.segmentHasPassenger.none() && ride.segmentHasPassenger.isSubsetOf(ride.passengerBuckled);
+}
+
+static RideEvent doDispatch(RideState& ride, const RideEventArgs&)
+{
+    ride.sickPassengerIndex = -1;
+    ride.passengerSick.clear();
+    ride.rideTime = 0.0;
+    return RideEvent::None;
+}
+
+static bool seatHasPassenger(const RideState& ride, const RideEventArgs& args)
+{
+    return seatInRange(ride, args) && ride.segmentHasPassenger.test(args.seat);
+}
+
+// putniku na sedistu seat je pozlilo
+static RideEvent doEmergency(RideState& ride, const RideEventArgs& args)
+{
+    ride.passengerSick.set(args.seat);
+    ride.sickPassengerIndex = args.seat;
+    ride.emergencyStop = predictEmergencyStop(ride.sHead, ride.currentSpeed, args.trackTotalLength);
+    return RideEvent::None;
+}
+
+static RideEvent doReachEnd(RideState& ride, const RideEventArgs& args)
+{
+    ride.sHead = args.trackTotalLength;
+    ride.currentSpeed = 0.0f;
+    return RideEvent::None;
+}
+
+static RideEvent doStop(RideState& ride, const RideEventArgs&)
+{
+    ride.currentSpeed = 0.0f;
+    return RideEvent::None;
+}
+
+static RideEvent doReachStation(RideState& ride, const RideEventArgs&)
+{
+    ride.sHead = ride.train.startSHead;
+    ride.currentSpeed = 0.0f;
+
+    // svi putnici se odvezuju i vracaju u normalno stanje
+    ride.passengerBuckled.clear();
+    ride.passengerSick.clear();
+
+    // rezim uklanjanja putnika samo ako ih ima
+    return ride.segmentHasPassenger.none() ? RideEvent::Unloaded : RideEvent::None;
+}
+
+// klik uklanja putnika
+static RideEvent doPassengerOff(RideState& ride, const RideEventArgs& args)
+{
+    ride.segmentHasPassenger.reset(args.seat);
+    ride.passengerBuckled.reset(args.seat);
+    ride.passengerSick.reset(args.seat);
+
+    return ride.segmentHasPassenger.none() ? RideEvent::Unloaded : RideEvent::None;
+}
+
+static const RideTransition RIDE_TRANSITIONS[] = {
+    { RidePhase::Loading,             RideEvent::AddPassenger,   RidePhase::Loading,             canAddPassenger,  doAddPassenger },
+    { RidePhase::Loading,             RideEvent::Buckle,         RidePhase::Loading,             canBuckle,        doBuckle },
+    { RidePhase::Loading,             RideEvent::Dispatch,       RidePhase::Running,             canDispatch,      doDispatch },
+    { RidePhase::Running,             RideEvent::Emergency,      RidePhase::EmergencyDecel,      seatHasPassenger, doEmergency },
+    { RidePhase::Running,             RideEvent::ReachedEnd,     RidePhase::WaitingBeforeReturn, nullptr,          doReachEnd },
+    { RidePhase::EmergencyDecel,      RideEvent::Stopped,        RidePhase::EmergencyWaiting,    nullptr,          doStop },
+    { RidePhase::EmergencyWaiting,    RideEvent::WaitElapsed,    RidePhase::EmergencyReturning,  nullptr,          nullptr },
+    { RidePhase::WaitingBeforeReturn, RideEvent::WaitElapsed,    RidePhase::Returning,           nullptr,          nullptr },
+    { RidePhase::Returning,           RideEvent::ReachedStation, RidePhase::Disembarking,        nullptr,          doReachStation },
+    { RidePhase::EmergencyReturning,  RideEvent::ReachedStation, RidePhase::Disembarking,        nullptr,          doReachStation },
+    { RidePhase::Disembarking,        RideEvent::PassengerOff,   RidePhase::Disembarking,        seatHasPassenger, doPassengerOff },
+    { RidePhase::Disembarking,        RideEvent::Unloaded,       RidePhase::Loading,             nullptr,          nullptr },
+};
+
+// RideTable
+// Gusta tabela [faza][dogadjaj] napravljena iz liste iznad, pa je
+// trazenje prelaza jedno indeksiranje. Prazno polje ima to == Count.
+struct RideTable {
+    RideTransition cells[static_cast<int>(RidePhase::Count)][static_cast<int>(RideEvent::Count)];
+
+    RideTable() {
+        for (auto& row : cells) {
+            for (auto& cell : row) cell = { RidePhase::Count, RideEvent::None, RidePhase::Count, nullptr, nullptr };
+        }
+        for (const RideTransition& t : RIDE_TRANSITIONS) {
+            cells[static_cast<int>(t.from)][static_cast<int>(t.event)] = t;
+        }
+    }
+};
+
+static const RideTable RIDE_TABLE;
+
+bool fireRideEvent(RideState& ride, RideEvent event, float trackTotalLength, int seat)
+{
+    RideEventArgs args = { seat, trackTotalLength };
+
+    const RideTransition& t = RIDE_TABLE.cells[static_cast<int>(ride.phase)][static_cast<int>(event)];
+    if (t.to == RidePhase::Count) return false;
+    if (t.guard && !t.guard(ride, args)) return false;
+
+    RideEvent next = t.action ? t.action(ride, args) : RideEvent::None;
+
+    RideLogEntry& entry = ride.log.entries[ride.log.count % RIDE_LOG_SIZE];
+    entry.seq = ride.log.count++;
+    entry.event = event;
+    entry.from = ride.phase;
+    entry.to = t.to;
+    entry.seat = static_cast<short>(seat);
+
+    ride.phase = t.to;
+
+    if (next != RideEvent::None) fireRideEvent(ride, next, trackTotalLength);
+    return true;
+}
+
+void onRideTimer(RideState& ride, int kind, float trackTotalLength)
+{
+    ride.returnTimer = -1;
+
+    // tabela zna da li je voz jos u fazi cekanja
+    if (kind == RIDE_TIMER_WAIT_BEFORE_RETURN || kind == RIDE_TIMER_EMERGENCY_WAIT) {
+        fireRideEvent(ride, RideEvent::WaitElapsed, trackTotalLength);
+    }
+}
+
+// integrateRun
+// Jedan korak voznje uzivo: gravitacija i deonice staze.
+static void integrateRun(
+    double deltaTime,
+    RideState& ride,
+    const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>& trackRuns
+)
+{
+    float dt = static_cast<float>(deltaTime);
+
+    // deo staze za racunanje nagiba
+    float ds = trackTotalLength / NUM_TRACK_POINTS;
+
+    float x0, y0, x1, y1;
+    getPointOnTrack(ride.sHead, ride.cursor, x0, y0, vertices, trackS, trackRuns, trackTotalLength);
+    TrackCursor ahead = ride.cursor;
+    getPointOnTrack(ride.sHead + ds, ahead, x1, y1, vertices, trackS, trackRuns, trackTotalLength);
+
+    float dy = y1 - y0;            // ako je dy < 0 -> nizbrdica, dy > 0 -> uzbrdica
+
+    // deonica na kojoj je glava voza, kursor je vec na njoj
+    SegmentType type = SegmentType::Normal;
+    float targetSpeed = 0.0f;
+    if (!trackRuns.empty()) {
+        type = trackRuns[ride.cursor.run].type;
+        targetSpeed = trackRuns[ride.cursor.run].targetSpeed;
+    }
+
+    // update brzine
+    switch (type) {
+    case SegmentType::Normal: {
+        float accel = START_ACCEL + (-dy) * GRAVITY_ACCEL; //uzbrdo sporije, nizbrdo brze
+        ride.currentSpeed += accel * dt;
+        break;
+    }
+    case SegmentType::Lift:
+        ride.currentSpeed = targetSpeed;
+        break;
+    case SegmentType::Launch:
+        ride.currentSpeed = std::min(targetSpeed, ride.currentSpeed + LAUNCH_ACCEL * dt);
+        break;
+    case SegmentType::Station:
+    case SegmentType::Brake:
+        // prebrz voz se koci, prespor se gura tockovima
+        if (ride.currentSpeed > targetSpeed)
+            ride.currentSpeed = std::max(targetSpeed, ride.currentSpeed - BRAKE_DECEL * dt);
+        else
+            ride.currentSpeed = std::min(targetSpeed, ride.currentSpeed + START_ACCEL * dt);
+        break;
+    }
+
+    if (ride.currentSpeed > MAX_SPEED) ride.currentSpeed = MAX_SPEED;
+    if (ride.currentSpeed < MIN_SPEED) ride.currentSpeed = MIN_SPEED;
+
+    // pomeranje po stazi
+    ride.sHead += ride.currentSpeed * dt;
+}
+
+void updateState(
+    double deltaTime,
+    RideState& ride,
+    const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>& trackRuns,
+    const RideTrajectory& trajectory,
+    TimerWheel& timers,
+    int trainId
+)
+{
+    // cekanje pre povratka odbrojava TimerWheel, vidi onRideTimer
+    switch (ride.phase) {
+    case RidePhase::Running: {
+        bool reachedEnd;
+        if (!trajectory.s.empty()) {
+            // bez hitne situacije voznja se samo cita iz tabele
+            ride.rideTime += deltaTime;
+            reachedEnd = ride.rideTime >= trajectory.duration;
+            if (!reachedEnd) {
+                sampleRideTrajectory(trajectory, ride.rideTime, ride.sHead, ride.currentSpeed);
+                seekTrackCursor(ride.cursor, ride.sHead, trackS, trackRuns);
+            }
+        }
+        else {
+            integrateRun(deltaTime, ride, trackS, trackTotalLength, vertices, trackRuns);
+            reachedEnd = ride.sHead >= trackTotalLength;
+        }
+
+        if (reachedEnd) {
+            fireRideEvent(ride, RideEvent::ReachedEnd, trackTotalLength);
+            ride.returnTimer = timers.schedule(WAIT_TIME, trainId, RIDE_TIMER_WAIT_BEFORE_RETURN);
+        }
+        break;
+    }
+
+    case RidePhase::EmergencyDecel:
+        ride.currentSpeed -= EMERGENCY_DECEL * static_cast<float>(deltaTime);
+        if (ride.currentSpeed < 0.0f) ride.currentSpeed = 0.0f;
+
+        // voz se pomera jos malo dok ne stane
+        ride.sHead += ride.currentSpeed * static_cast<float>(deltaTime);
+
+        if (ride.sHead > trackTotalLength) {
+            ride.sHead = trackTotalLength;
+        }
+
+        // ceka 10 sekundi
+        if (ride.currentSpeed <= EMERGENCY_STOP_SPEED) {
+            fireRideEvent(ride, RideEvent::Stopped, trackTotalLength);
+            ride.returnTimer = timers.schedule(EMERGENCY_WAIT_TIME, trainId, RIDE_TIMER_EMERGENCY_WAIT);
+        }
+        break;
+
+    // povratak voza unazad konstantnom brzinom
+    case RidePhase::Returning:
+    case RidePhase::EmergencyReturning: {
+        float usedReturnSpeed = ride.phase == RidePhase::EmergencyReturning ? EMERGENCY_RETURN_SPEED
+            : RETURN_SPEED;
+
+        ride.sHead -= usedReturnSpeed * static_cast<float>(deltaTime);
+
+        if (ride.sHead <= ride.train.startSHead) {
+            fireRideEvent(ride, RideEvent::ReachedStation, trackTotalLength);
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+// racuna offset za svaki segment za ovaj frejm
+// Segmenti su poredjani unazad od glave, pa jedan kursor ide redom kroz njih.
+void updateSegmentOffsets(
+    const RideState& ride,
+    const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>& trackRuns,
+    std::vector<float>& segOffsetX,
+    std::vector<float>& segOffsetY
+)
+{
+    TrackCursor cursor = ride.cursor;
+    for (int i = 0; i < ride.train.carCount; ++i) {
+        float sSeg = ride.sHead - i * ride.train.spacing;
+
+        // kvadrati vagona su oko (0, 0), pa je offset sama tacka na stazi
+        getPointOnTrack(sSeg, cursor, segOffsetX[i], segOffsetY[i],
+            vertices, trackS, trackRuns, trackTotalLength);
+    }
+}
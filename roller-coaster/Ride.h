@@ -0,0 +1,288 @@
+#pragma once
+#include "SeatMask.h"
+
+#include <vector>
+#include <cstdint>
+
+class TimerWheel;
+
+struct Vertex {
+    float x, y;
+    float u, v;
+};
+
+// vrste deonica staze
+enum class SegmentType : unsigned char {
+    Normal,  // gravitacija + START_ACCEL
+    Station, // tockovi vode voz do zadate brzine
+    Lift,    // lanac vuce konstantnom brzinom
+    Brake,   // magnetna kocnica spusta brzinu do zadate
+    Launch   // lanser ubrzava do zadate brzine
+};
+
+// TrackRun
+// Niz uzastopnih segmenata staze istog tipa (run-length zapis uz trackS).
+// Segment i je deo staze izmedju verteksa i i i+1.
+struct TrackRun {
+    int firstSegment;
+    int endSegment; // prvi segment posle ovog niza
+    SegmentType type;
+    float targetSpeed;
+};
+
+// TrackCursor
+// Pamti segment i niz u kome je voz bio u proslom koraku, pa se
+// sledeca pozicija nalazi pomeranjem od tog mesta umesto pretrage od pocetka.
+struct TrackCursor {
+    int segment = 0;
+    int run = 0;
+};
+
+// KONSTANTE ZA STAZU
+constexpr int   NUM_TRACK_POINTS = 200;
+constexpr float NUM_HILLS = 5.0f;
+
+// KONSTANTE ZA VAGON
+constexpr int   WAGON_SEGMENTS = 8;        // podrazumevan broj vagona, menja se sa --cars
+constexpr int   MAX_WAGON_SEGMENTS = 4096;
+constexpr int   WAGON_VERTEX_COUNT_PER_SEGMENT = 4;
+constexpr float WAGON_SEGMENT_SIZE = 0.1f; // najveca stranica vagona
+constexpr float WAGON_GAP = 0.002f;
+constexpr int   PASSENGER_VERTEX_COUNT_PER_SEGMENT = 4;
+// dug voz se smanjuje tako da zauzme najvise ovaj deo staze
+constexpr float MAX_TRAIN_TRACK_FRACTION = 0.3f;
+
+// ubrzanje i brzina
+const float START_ACCEL = 0.4f;
+const float GRAVITY_ACCEL = 1.8f;
+const float MAX_SPEED = 1.6f;
+const float MIN_SPEED = 0.1f;
+
+// brzine i ubrzanja posebnih deonica
+const float STATION_EXIT_SPEED = 0.35f;
+const float LIFT_SPEED = 0.35f;
+const float BRAKE_SPEED = 0.25f;
+const float BRAKE_DECEL = 1.5f;
+const float LAUNCH_SPEED = 1.5f;
+const float LAUNCH_ACCEL = 2.5f;
+
+// konstanta brzina povratka
+const float RETURN_SPEED = 0.8f;
+const float EMERGENCY_RETURN_SPEED = 0.3f;
+// negativno ubrzanje
+const float EMERGENCY_DECEL = 1.2f;
+// ispod ove brzine se smatra da je voz stao
+const float EMERGENCY_STOP_SPEED = 0.01f;
+
+// TrainLayout
+// Duzina voza se bira pri pokretanju. Sve sto zavisi od broja vagona
+// (velicina vagona, razmak, polozaj glave u stanici) cita se odavde.
+struct TrainLayout {
+    int carCount = WAGON_SEGMENTS;
+    float carSize = WAGON_SEGMENT_SIZE;
+    float spacing = WAGON_SEGMENT_SIZE + WAGON_GAP;                          // razmak vagona duz staze
+    float startSHead = (WAGON_SEGMENTS - 1) * (WAGON_SEGMENT_SIZE + WAGON_GAP); // glava voza u stanici
+};
+
+const double WAIT_TIME = 3.0;
+const double EMERGENCY_WAIT_TIME = 10.0;
+
+// StopPrediction
+// Gde ce i kada voz stati ako se sad pokrene hitno kocenje.
+struct StopPrediction {
+    float sStop;
+    double timeToStop;
+};
+
+// RideTrajectory
+// Nominalna voznja bez hitne situacije od stanice do kraja staze,
+// uzorkovana sa fiksnim korakom. Ista je za svaki polazak, pa se racuna
+// jednom po stazi i parametrima, a u toku voznje se samo cita.
+struct RideTrajectory {
+    double step = 0.0;
+    double duration = 0.0;  // vreme do kraja staze
+    std::vector<float> s;   // s[k] i v[k] posle k koraka
+    std::vector<float> v;
+};
+
+const double TRAJECTORY_STEP = 1.0 / 240.0;
+
+// RidePhase
+// Faza voznje. Voz je uvek u tacno jednoj fazi, prelaze odredjuje
+// tabela u Ride.cpp (fireRideEvent).
+enum class RidePhase : unsigned char {
+    Loading,             // u stanici, putnici ulaze i vezuju se
+    Running,
+    EmergencyDecel,
+    EmergencyWaiting,
+    WaitingBeforeReturn, // na kraju staze
+    Returning,
+    EmergencyReturning,  // povratak posle hitnog kocenja, sporiji
+    Disembarking,
+    Count
+};
+
+enum class RideEvent : unsigned char {
+    None,
+    AddPassenger,   // SPACE
+    Buckle,         // klik na putnika
+    Dispatch,       // ENTER
+    Emergency,      // tasteri 1-8
+    ReachedEnd,
+    Stopped,        // hitno kocenje je zaustavilo voz
+    WaitElapsed,
+    ReachedStation,
+    PassengerOff,   // klik na putnika pri iskrcavanju
+    Unloaded,       // izasao je poslednji putnik
+    Count
+};
+
+// RideEventLog
+// Kruzni dnevnik poslednjih prelaza, upis je par dodela bez alokacije.
+struct RideLogEntry {
+    uint32_t seq;
+    RideEvent event;
+    RidePhase from;
+    RidePhase to;
+    short seat;
+};
+
+const int RIDE_LOG_SIZE = 64;
+
+struct RideEventLog {
+    RideLogEntry entries[RIDE_LOG_SIZE];
+    uint32_t count = 0;
+};
+
+// vrste tajmera voza u TimerWheel
+enum RideTimerKind {
+    RIDE_TIMER_WAIT_BEFORE_RETURN,
+    RIDE_TIMER_EMERGENCY_WAIT
+};
+
+// RideState
+// Stanje jednog voza: polozaj, brzina, faze voznje i putnici.
+// Isto stanje menjaju i tastatura/mis i simulacija stanice.
+struct RideState {
+    RideState() {}
+    explicit RideState(const TrainLayout& layout)
+        : train(layout), sHead(layout.startSHead), segmentHasPassenger(layout.carCount),
+        passengerBuckled(layout.carCount), passengerSick(layout.carCount) {}
+
+    TrainLayout train;
+
+    float sHead = TrainLayout().startSHead;
+    float currentSpeed = 0.0f;
+    TrackCursor cursor;
+    double rideTime = 0.0; // vreme od polaska, za citanje iz RideTrajectory
+
+    RidePhase phase = RidePhase::Loading;
+    RideEventLog log;
+
+    // hitna situacija
+    int sickPassengerIndex = -1;
+    StopPrediction emergencyStop = { 0.0f, 0.0 };
+
+    // tajmer cekanja pre povratka u TimerWheel, -1 ako ne ceka
+    int returnTimer = -1;
+
+    //da li je odredjeni segment popunjen putnikom, broj putnika je count()
+    SeatMask segmentHasPassenger = SeatMask(WAGON_SEGMENTS);
+
+    // da li je putnik vezan pojasom
+    SeatMask passengerBuckled = SeatMask(WAGON_SEGMENTS);
+
+    // da li je putniku pozlilo
+    SeatMask passengerSick = SeatMask(WAGON_SEGMENTS);
+};
+
+void buildTrack(std::vector<Vertex>& vertices,
+    std::vector<float>& trackS,
+    float& trackTotalLength);
+
+// makeTrainLayout
+// Raspored za voz od carCount vagona na stazi date duzine.
+TrainLayout makeTrainLayout(int carCount, float trackTotalLength);
+
+// buildTrackAttributes
+// Podrazumevani raspored deonica za stazu iz buildTrack.
+void buildTrackAttributes(const std::vector<Vertex>& vertices,
+    const std::vector<float>& trackS,
+    const TrainLayout& train,
+    std::vector<TrackRun>& trackRuns);
+
+// buildTrain
+// Jedan kvadrat vagona i jedan kvadrat putnika oko tacke (0, 0) na stazi.
+// Svi vagoni ih dele, a polozaj svakog stize kao offset instance.
+void buildTrain(std::vector<Vertex>& vertices,
+    const TrainLayout& train,
+    int& wagonStartIndex,
+    int& passengerStartIndex);
+
+// seekTrackCursor
+// Pomera kursor do segmenta koji sadrzi s. Za mali pomak je O(1).
+void seekTrackCursor(TrackCursor& cursor,
+    float s,
+    const std::vector<float>& trackS,
+    const std::vector<TrackRun>& trackRuns);
+
+void getPointOnTrack(float s,
+    TrackCursor& cursor,
+    float& outX,
+    float& outY,
+    const std::vector<Vertex>& vertices,
+    const std::vector<float>& trackS,
+    const std::vector<TrackRun>& trackRuns,
+    float trackTotalLength);
+
+// predictEmergencyStop
+// Zatvoren oblik za hitno kocenje konstantnim EMERGENCY_DECEL iz tacke (s, v),
+// bez simulacije unapred. Voz ne moze da prodje kraj staze.
+StopPrediction predictEmergencyStop(float s, float v, float trackTotalLength);
+
+// buildRideTrajectory
+// Vozi voz kroz updateState (bez tabele) i pamti s(t) i v(t).
+void buildRideTrajectory(const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>& trackRuns,
+    const TrainLayout& train,
+    double step,
+    RideTrajectory& trajectory);
+
+// sampleRideTrajectory
+// Polozaj i brzina u trenutku t od polaska, linearno izmedju uzoraka.
+void sampleRideTrajectory(const RideTrajectory& trajectory, double t, float& outS, float& outV);
+
+// fireRideEvent
+// Salje dogadjaj masini stanja. Ako ga trenutna faza ne prihvata ili
+// uslov nije ispunjen vraca false i nista ne menja. seat je sediste za
+// Buckle, Emergency i PassengerOff.
+bool fireRideEvent(RideState& ride, RideEvent event, float trackTotalLength, int seat = -1);
+
+// poziva se za svaki istekli tajmer ovog voza
+void onRideTimer(RideState& ride, int kind, float trackTotalLength);
+
+void updateState(
+    double deltaTime,
+    RideState& ride,
+    const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>& trackRuns,
+    const RideTrajectory& trajectory, // prazna -> integracija u svakom koraku
+    TimerWheel& timers,
+    int trainId
+);
+
+// updateSegmentOffsets
+// Tacka na stazi ispod svakog vagona, segOffsetX/Y imaju train.carCount elemenata.
+void updateSegmentOffsets(
+    const RideState& ride,
+    const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>& trackRuns,
+    std::vector<float>& segOffsetX,
+    std::vector<float>& segOffsetY
+);
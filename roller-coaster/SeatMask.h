@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+inline int popcount64(uint64_t x)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(x));
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return static_cast<int>((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// indeks najnizeg postavljenog bita, x != 0
+inline int lowestBit64(uint64_t x)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    return popcount64((x & (0 - x)) - 1);
+#endif
+}
+
+// najvise sedista koje SeatMask drzi u sebi, bez alokacije
+const int SEAT_MASK_INLINE_SEATS = 64;
+
+// SeatMask
+// Po jedan bit za svako sediste u vozu, pakovano u 64-bitne reci. Za voz
+// do SEAT_MASK_INLINE_SEATS vagona to je jedna rec u samoj maski, bez alokacije, pa su provere
+// "svi vezani" i brojanje putnika jedna operacija umesto petlje po vagonima.
+// Duzi voz drzi reci u vektoru.
+class SeatMask {
+public:
+    SeatMask() {}
+    explicit SeatMask(int seatCount) : wordCount((seatCount + 63) / 64)
+    {
+        if (wordCount > 1) heapWords.assign(wordCount, 0);
+    }
+
+    bool test(int seat) const { return (words()[seat >> 6] >> (seat & 63)) & 1; }
+    void set(int seat) { words()[seat >> 6] |= 1ull << (seat & 63); }
+    void reset(int seat) { words()[seat >> 6] &= ~(1ull << (seat & 63)); }
+
+    void clear()
+    {
+        uint64_t* w = words();
+        for (int i = 0; i < wordCount; ++i) w[i] = 0;
+    }
+
+    int count() const
+    {
+        const uint64_t* w = words();
+        int n = 0;
+        for (int i = 0; i < wordCount; ++i) n += popcount64(w[i]);
+        return n;
+    }
+
+    bool none() const
+    {
+        const uint64_t* w = words();
+        for (int i = 0; i < wordCount; ++i) if (w[i] != 0) return false;
+        return true;
+    }
+
+    // svaki bit iz ove maske postoji i u other
+    bool isSubsetOf(const SeatMask& other) const
+    {
+        const uint64_t* w = words();
+        const uint64_t* o = other.words();
+        for (int i = 0; i < wordCount; ++i) {
+            if (w[i] & ~o[i]) return false;
+        }
+        return true;
+    }
+
+    // prvi postavljen bit od seat nadalje, -1 ako ga nema
+    int nextSet(int seat) const
+    {
+        int i = seat >> 6;
+        if (i >= wordCount) return -1;
+
+        const uint64_t* maskWords = words();
+        uint64_t w = maskWords[i] & (~0ull << (seat & 63));
+        while (w == 0) {
+            if (++i == wordCount) return -1;
+            w = maskWords[i];
+        }
+        return i * 64 + lowestBit64(w);
+    }
+
+    // prvo slobodno sediste manje od seatCount, -1 ako su sva zauzeta
+    int firstClear(int seatCount) const
+    {
+        const uint64_t* w = words();
+        for (int i = 0; i < wordCount; ++i) {
+            uint64_t free = ~w[i];
+            if (free == 0) continue;
+            int seat = i * 64 + lowestBit64(free);
+            return seat < seatCount ? seat : -1;
+        }
+        return -1;
+    }
+
+    SeatMask& operator&=(const SeatMask& other)
+    {
+        uint64_t* w = words();
+        const uint64_t* o = other.words();
+        for (int i = 0; i < wordCount; ++i) w[i] &= o[i];
+        return *this;
+    }
+
+    // brise bitove koji su postavljeni u other
+    SeatMask& andNot(const SeatMask& other)
+    {
+        uint64_t* w = words();
+        const uint64_t* o = other.words();
+        for (int i = 0; i < wordCount; ++i) w[i] &= ~o[i];
+        return *this;
+    }
+
+private:
+    // pokazivac se ne cuva, pa kopija maske ne pokazuje na tudju rec
+    uint64_t* words() { return wordCount > 1 ? heapWords.data() : &inlineWord; }
+    const uint64_t* words() const { return wordCount > 1 ? heapWords.data() : &inlineWord; }
+
+    int wordCount = 0;
+    uint64_t inlineWord = 0;          // voz do 64 vagona
+    std::vector<uint64_t> heapWords;  // samo za duzi voz
+};
@@ -0,0 +1,219 @@
+#include "SimThread.h"
+#include "TimerWheel.h"
+#include "Train.h"
+#include "PickGrid.h"
+
+#include <GLFW/glfw3.h>
+
+#include <thread>
+#include <chrono>
+
+// vraca true ako je taster promenio stanje voza
+static bool handleKeyPress(
+    int key,
+    RideState& ride,
+    float trackTotalLength
+)
+{
+    bool changed = false;
+
+    // SPACE dodaje putnika
+    if (key == GLFW_KEY_SPACE) {
+        changed = fireRideEvent(ride, RideEvent::AddPassenger, trackTotalLength);
+    }
+
+    // ENTER pokrece voz samo ako su svi putnici vezani
+    if (key == GLFW_KEY_ENTER) {
+        changed = fireRideEvent(ride, RideEvent::Dispatch, trackTotalLength);
+    }
+
+    // tasteri 1-8, samo prvi se prihvata jer posle njega voz vise nije u fazi Running
+    // za duzi voz tasteri su ravnomerno rasporedjeni duz voza
+    int keyIndex = key - GLFW_KEY_1;
+    if (keyIndex >= 0 && keyIndex < 8) {
+        int seat = keyIndex * ride.train.carCount / 8;
+        // predvidjeno zaustavljanje ostaje u ride.emergencyStop
+        if (fireRideEvent(ride, RideEvent::Emergency, trackTotalLength, seat)) changed = true;
+    }
+    return changed;
+}
+
+// klik na sediste: vezivanje, a pri iskrcavanju silazak
+// vraca true ako je na sedistu putnik koji moze da se klikne
+static bool clickSeat(int seat, RideState& ride, float trackTotalLength)
+{
+    bool disembarking = (ride.phase == RidePhase::Disembarking);
+    return fireRideEvent(ride, disembarking ? RideEvent::PassengerOff : RideEvent::Buckle,
+        trackTotalLength, seat);
+}
+
+// vraca true ako je klik pogodio putnika
+static bool handleMouseClick(
+    float xNdc, // klik u ndc
+    float yNdc,
+    RideState& ride,
+    float trackTotalLength,
+    const PickGrid& pickGrid,
+    const float* segOffsetX,
+    const float* segOffsetY
+)
+{
+    bool disembarking = (ride.phase == RidePhase::Disembarking);
+
+    // kandidati za klik: pri iskrcavanju svi putnici, inace samo nevezani
+    SeatMask candidates = ride.segmentHasPassenger;
+    if (!disembarking) candidates.andNot(ride.passengerBuckled);
+
+    int seat = pickGrid.pick(xNdc, yNdc, segOffsetX, segOffsetY, candidates);
+    if (seat < 0) return false;
+
+    return clickSeat(seat, ride, trackTotalLength);
+}
+
+// granice kvadrata putnika koji dele svi vagoni
+static PickGrid makePickGrid(int carCount, int PASSENGER_START_INDEX, const std::vector<Vertex>& vertices)
+{
+    const Vertex& v0 = vertices[PASSENGER_START_INDEX + 0];
+    float minX = v0.x, maxX = v0.x;
+    float minY = v0.y, maxY = v0.y;
+    for (int k = 1; k < PASSENGER_VERTEX_COUNT_PER_SEGMENT; ++k) {
+        const Vertex& v = vertices[PASSENGER_START_INDEX + k];
+        if (v.x < minX) minX = v.x;
+        if (v.x > maxX) maxX = v.x;
+        if (v.y < minY) minY = v.y;
+        if (v.y > maxY) maxY = v.y;
+    }
+    return PickGrid(carCount, minX, minY, maxX, maxY);
+}
+
+// processInputEvents
+// Prazni red dogadjaja koji su upisali GLFW callback-ovi. Kad nema
+// dogadjaja, nema ni posla oko ulaza. Ulazi koji su promenili stanje
+// idu u appliedInputs sa verzijom snimka u kojoj ce se videti.
+static void processInputEvents(
+    InputQueue& inputQueue,
+    AppliedInputQueue& appliedInputs,
+    uint64_t nextVersion,
+    RideState& ride,
+    float trackTotalLength,
+    const PickGrid& pickGrid,
+    const float* segOffsetX,
+    const float* segOffsetY
+)
+{
+    InputEvent event;
+    while (inputQueue.pop(event)) {
+        if (event.type == InputEventType::Key) {
+            if (handleKeyPress(event.key, ride, trackTotalLength)) {
+                LatencyKind kind = LatencyKind::Other;
+                if (event.key == GLFW_KEY_ENTER) kind = LatencyKind::Dispatch;
+                else if (event.key >= GLFW_KEY_1 && event.key <= GLFW_KEY_9) kind = LatencyKind::Emergency;
+                appliedInputs.push({ kind, event.time, nextVersion });
+            }
+        }
+        else if (event.type == InputEventType::MouseClick) {
+            if (handleMouseClick(event.xNdc, event.yNdc, ride, trackTotalLength,
+                pickGrid, segOffsetX, segOffsetY)) {
+                appliedInputs.push({ LatencyKind::Other, event.time, nextVersion });
+            }
+        }
+        else {
+            // sediste je vec nasao GPU, tabela proverava da li je putnik tu i nevezan
+            if (clickSeat(event.key, ride, trackTotalLength)) {
+                appliedInputs.push({ LatencyKind::Other, event.time, nextVersion });
+            }
+        }
+    }
+}
+
+// runSimulationLoop
+// TrainT je Train<N> ili DynamicTrain, izabran u runSimulationThread.
+template <typename TrainT>
+static void runSimulationLoop(SimContext& ctx, TrainT& cars)
+{
+    const float trackTotalLength = ctx.trackTotalLength;
+
+    // stanje voza je u cars, za Train<N> bez alokacije
+    RideState& ride = cars.ride;
+
+    // tajmeri voza (cekanje na kraju staze i posle hitnog zaustavljanja)
+    TimerWheel rideTimers;
+    std::vector<TimerExpiry> expiredTimers;
+
+    // mreza za klik prati vagone od prvog koraka
+    PickGrid pickGrid = makePickGrid(ctx.train.carCount, ctx.passengerStartIndex, *ctx.vertices);
+    updateTrainOffsets(*ctx.trackS, trackTotalLength, *ctx.vertices, *ctx.trackRuns, cars);
+    pickGrid.update(cars.offsetX.data(), cars.offsetY.data());
+
+    uint64_t version = 0;
+    double lastTime = glfwGetTime();
+
+    while (!ctx.stop.load(std::memory_order_relaxed)) {
+        double stepStart = glfwGetTime();
+        double deltaTime = stepStart - lastTime;
+        lastTime = stepStart;
+
+        processInputEvents(
+            *ctx.inputQueue,
+            *ctx.appliedInputs,
+            version + 1,
+            ride,
+            trackTotalLength,
+            pickGrid,
+            cars.offsetX.data(),
+            cars.offsetY.data()
+        );
+
+        updateState(
+            deltaTime,
+            ride,
+            *ctx.trackS,
+            trackTotalLength,
+            *ctx.vertices,
+            *ctx.trackRuns,
+            *ctx.trajectory,
+            rideTimers,
+            0
+        );
+
+        expiredTimers.clear();
+        rideTimers.advance(deltaTime, expiredTimers);
+        for (const TimerExpiry& expiry : expiredTimers) {
+            onRideTimer(ride, expiry.kind, trackTotalLength);
+        }
+
+        // render postavlja vagone na GPU iz sHead, offseti trebaju samo mrezi za klik
+        updateTrainOffsets(
+            *ctx.trackS,
+            trackTotalLength,
+            *ctx.vertices,
+            *ctx.trackRuns,
+            cars
+        );
+        pickGrid.update(cars.offsetX.data(), cars.offsetY.data());
+
+        // objava snimka, maske su iste velicine pa kopija ne alocira
+        RideSnapshot& snapshot = ctx.snapshots->writeBuffer();
+        snapshot.version = ++version;
+        snapshot.phase = ride.phase;
+        snapshot.sHead = ride.sHead;
+        snapshot.segmentHasPassenger = ride.segmentHasPassenger;
+        snapshot.passengerBuckled = ride.passengerBuckled;
+        snapshot.passengerSick = ride.passengerSick;
+        ctx.snapshots->publish();
+
+        double stepTime = glfwGetTime() - stepStart;
+        if (stepTime < SIM_STEP) {
+            std::this_thread::sleep_for(
+                std::chrono::duration<double>(SIM_STEP - stepTime)
+            );
+        }
+    }
+}
+
+void runSimulationThread(SimContext* context)
+{
+    visitTrain(context->train, [context](auto& cars) {
+        runSimulationLoop(*context, cars);
+    });
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "Ride.h"
+#include "Input.h"
+#include "Latency.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// korak simulacione niti, nezavisan od frejmova
+const double SIM_STEP = 1.0 / 240.0;
+
+// RideSnapshot
+// Sve sto render treba iz jednog koraka simulacije.
+struct RideSnapshot {
+    uint64_t version = 0;
+    RidePhase phase = RidePhase::Loading;
+    float sHead = 0.0f; // vagone na stazi postavlja sejder
+    SeatMask segmentHasPassenger;
+    SeatMask passengerBuckled;
+    SeatMask passengerSick;
+};
+
+// ulaz koji je promenio stanje i verzija snimka u kojoj se to prvi put vidi
+struct AppliedInput {
+    LatencyKind kind;
+    double inputTime;
+    uint64_t version;
+};
+
+typedef SpscQueue<AppliedInput, 256> AppliedInputQueue;
+
+// SimContext
+// Ono sto simulaciona nit deli sa glavnom. Staza i geometrija se posle
+// pokretanja samo citaju, a sve ostalo ide kroz redove i trostruki bafer.
+struct SimContext {
+    const std::vector<Vertex>* vertices;
+    const std::vector<float>* trackS;
+    const std::vector<TrackRun>* trackRuns;
+    const RideTrajectory* trajectory;
+    float trackTotalLength;
+    TrainLayout train;
+    int passengerStartIndex;
+
+    InputQueue* inputQueue;               // glavna nit -> simulacija
+    TripleBuffer<RideSnapshot>* snapshots; // simulacija -> render
+    AppliedInputQueue* appliedInputs;      // simulacija -> render, za merenje kasnjenja
+
+    std::atomic<bool> stop{ false };
+};
+
+// runSimulationThread
+// Petlja simulacione niti: ulaz, updateState, tajmeri, offseti i objava
+// snimka na svakih SIM_STEP sekundi, dok se ne postavi stop.
+void runSimulationThread(SimContext* context);
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// SpscQueue
+// Red bez zakljucavanja za tacno jednog proizvodjaca i jednog potrosaca.
+// Kapacitet mora biti stepen dvojke. push vraca false kad je red pun,
+// pop vraca false kad je prazan.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity mora biti stepen dvojke");
+
+public:
+    bool push(const T& value)
+    {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headCache == Capacity) {
+            headCache = headIndex.load(std::memory_order_acquire);
+            if (tail - headCache == Capacity) return false;
+        }
+        items[tail & (Capacity - 1)] = value;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out)
+    {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailCache) {
+            tailCache = tailIndex.load(std::memory_order_acquire);
+            if (head == tailCache) return false;
+        }
+        out = items[head & (Capacity - 1)];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return headIndex.load(std::memory_order_acquire) == tailIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    // proizvodjac i potrosac su na razlicitim kes linijama
+    alignas(64) std::atomic<size_t> tailIndex{ 0 };
+    size_t headCache = 0; // proizvodjacev poslednji pogled na head
+
+    alignas(64) std::atomic<size_t> headIndex{ 0 };
+    size_t tailCache = 0; // potrosacev poslednji pogled na tail
+
+    alignas(64) T items[Capacity];
+};
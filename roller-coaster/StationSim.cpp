@@ -0,0 +1,207 @@
+#include "StationSim.h"
+
+#include <queue>
+#include <deque>
+#include <random>
+#include <cstdint>
+
+enum class StationEventType {
+    GuestArrival,
+    Board,
+    Buckle,
+    Dispatch,
+    RideEnd,
+    Emergency,
+    EmergencyStopped,
+    WaitDone,
+    ReturnDone,
+    Unload
+};
+
+struct StationEvent {
+    double time;
+    uint64_t seq; // redosled ubacivanja, da bi isti trenuci bili deterministicki
+    int station;
+    int seat;
+    StationEventType type;
+};
+
+struct LaterEvent {
+    bool operator()(const StationEvent& a, const StationEvent& b) const {
+        if (a.time != b.time) return a.time > b.time;
+        return a.seq > b.seq;
+    }
+};
+
+struct Station {
+    RideState ride;
+    std::deque<double> queue;   // vremena dolaska gostiju koji cekaju
+    bool boarding = false;      // da li je Board dogadjaj vec zakazan
+    int pendingBuckles = 0;
+    double dispatchTime = 0.0;
+};
+
+StationSimStats runStationSimulation(const StationSimConfig& config,
+    float trackTotalLength,
+    const TrainLayout& train,
+    const RideTrajectory& trajectory)
+{
+    StationSimStats stats;
+
+    // voznja bez hitne situacije traje isto za svaki polazak
+    const double runTime = trajectory.duration;
+    stats.rideRunTime = runTime;
+
+    std::vector<Station> stations(config.stationCount);
+    for (Station& station : stations) station.ride = RideState(train);
+    std::priority_queue<StationEvent, std::vector<StationEvent>, LaterEvent> events;
+    uint64_t seq = 0;
+
+    auto schedule = [&](double time, int station, StationEventType type, int seat) {
+        events.push({ time, seq++, station, seat, type });
+    };
+
+    std::mt19937_64 rng(config.seed);
+    std::exponential_distribution<double> interArrival(config.guestsPerHour / 3600.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    for (int st = 0; st < config.stationCount; ++st) {
+        schedule(interArrival(rng), st, StationEventType::GuestArrival, -1);
+    }
+
+    // ukrcavanje pocinje ako je voz u stanici i ima gostiju u redu
+    auto tryBoard = [&](double now, int st) {
+        Station& station = stations[st];
+        if (!station.boarding && !station.queue.empty()
+            && station.ride.segmentHasPassenger.firstClear(train.carCount) >= 0
+            && station.ride.phase == RidePhase::Loading) {
+            station.boarding = true;
+            schedule(now + config.boardTime, st, StationEventType::Board, -1);
+        }
+    };
+
+    // operater pusta voz kad je pun ili kad vise niko ne ceka
+    auto tryDispatch = [&](double now, int st) {
+        Station& station = stations[st];
+        if (station.boarding || station.pendingBuckles > 0) return;
+        int passengers = station.ride.segmentHasPassenger.count();
+        if (passengers == 0) return;
+        if (passengers == train.carCount || station.queue.empty()) {
+            schedule(now, st, StationEventType::Dispatch, -1);
+        }
+    };
+
+    while (!events.empty()) {
+        StationEvent ev = events.top();
+        events.pop();
+        stats.eventsProcessed++;
+        stats.simulatedTime = ev.time;
+
+        Station& station = stations[ev.station];
+        RideState& ride = station.ride;
+
+        switch (ev.type) {
+        case StationEventType::GuestArrival:
+            if (ev.time > config.dayLength) break;
+            stats.guestsArrived++;
+            station.queue.push_back(ev.time);
+            if (static_cast<int>(station.queue.size()) > stats.maxQueueLength) {
+                stats.maxQueueLength = static_cast<int>(station.queue.size());
+            }
+            schedule(ev.time + interArrival(rng), ev.station, StationEventType::GuestArrival, -1);
+            tryBoard(ev.time, ev.station);
+            break;
+
+        case StationEventType::Board: {
+            station.boarding = false;
+            int seat = ride.segmentHasPassenger.firstClear(train.carCount);
+            if (!station.queue.empty() && fireRideEvent(ride, RideEvent::AddPassenger, trackTotalLength)) {
+                double wait = ev.time - station.queue.front();
+                station.queue.pop_front();
+                stats.totalQueueWait += wait;
+                if (wait > stats.maxQueueWait) stats.maxQueueWait = wait;
+
+                station.pendingBuckles++;
+                schedule(ev.time + config.buckleTime, ev.station, StationEventType::Buckle, seat);
+            }
+            tryBoard(ev.time, ev.station);
+            tryDispatch(ev.time, ev.station);
+            break;
+        }
+
+        case StationEventType::Buckle:
+            fireRideEvent(ride, RideEvent::Buckle, trackTotalLength, ev.seat);
+            station.pendingBuckles--;
+            tryDispatch(ev.time, ev.station);
+            break;
+
+        case StationEventType::Dispatch:
+            if (fireRideEvent(ride, RideEvent::Dispatch, trackTotalLength)) {
+                stats.rides++;
+                int passengers = ride.segmentHasPassenger.count();
+                stats.guestsRidden += passengers;
+                station.dispatchTime = ev.time;
+
+                if (unit(rng) < config.sickChancePerRide) {
+                    int seat = static_cast<int>(unit(rng) * passengers);
+                    schedule(ev.time + unit(rng) * runTime, ev.station, StationEventType::Emergency, seat);
+                }
+                else {
+                    schedule(ev.time + runTime, ev.station, StationEventType::RideEnd, -1);
+                }
+            }
+            break;
+
+        case StationEventType::Emergency:
+            // gde je voz u tom trenutku cita se iz tabele, a zaustavljanje se racuna unapred
+            sampleRideTrajectory(trajectory, ev.time - station.dispatchTime, ride.sHead, ride.currentSpeed);
+            if (fireRideEvent(ride, RideEvent::Emergency, trackTotalLength, ev.seat)) {
+                stats.emergencies++;
+                schedule(ev.time + ride.emergencyStop.timeToStop, ev.station, StationEventType::EmergencyStopped, -1);
+            }
+            break;
+
+        case StationEventType::EmergencyStopped:
+            ride.sHead = ride.emergencyStop.sStop;
+            fireRideEvent(ride, RideEvent::Stopped, trackTotalLength);
+            schedule(ev.time + EMERGENCY_WAIT_TIME, ev.station, StationEventType::WaitDone, -1);
+            break;
+
+        case StationEventType::RideEnd:
+            fireRideEvent(ride, RideEvent::ReachedEnd, trackTotalLength);
+            schedule(ev.time + WAIT_TIME, ev.station, StationEventType::WaitDone, -1);
+            break;
+
+        case StationEventType::WaitDone: {
+            fireRideEvent(ride, RideEvent::WaitElapsed, trackTotalLength);
+            float returnSpeed = ride.phase == RidePhase::EmergencyReturning ? EMERGENCY_RETURN_SPEED : RETURN_SPEED;
+            double returnTime = (ride.sHead - train.startSHead) / returnSpeed;
+            schedule(ev.time + returnTime, ev.station, StationEventType::ReturnDone, -1);
+            break;
+        }
+
+        case StationEventType::ReturnDone:
+            fireRideEvent(ride, RideEvent::ReachedStation, trackTotalLength);
+            if (ride.phase == RidePhase::Disembarking) {
+                schedule(ev.time + config.unloadTime, ev.station, StationEventType::Unload, 0);
+            }
+            break;
+
+        case StationEventType::Unload: {
+            // putnici izlaze jedan po jedan, od prvog vagona
+            int seat = ride.segmentHasPassenger.nextSet(ev.seat);
+            if (seat >= 0) fireRideEvent(ride, RideEvent::PassengerOff, trackTotalLength, seat);
+
+            if (ride.phase == RidePhase::Disembarking) {
+                schedule(ev.time + config.unloadTime, ev.station, StationEventType::Unload, seat + 1);
+            }
+            else {
+                tryBoard(ev.time, ev.station);
+            }
+            break;
+        }
+        }
+    }
+
+    return stats;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "Ride.h"
+
+#include <vector>
+
+// Parametri simulacije radnog dana stanice.
+// Svaka stanica ima svoj red gostiju i svoj voz.
+struct StationSimConfig {
+    int    stationCount = 200;
+    double dayLength = 12.0 * 3600.0;   // koliko dugo gosti dolaze (s)
+    double guestsPerHour = 600.0;       // po stanici
+    double boardTime = 2.0;             // ulazak jednog putnika u vagon (s)
+    double buckleTime = 3.0;            // vezivanje pojasa (s)
+    double unloadTime = 1.5;            // izlazak jednog putnika (s)
+    double sickChancePerRide = 0.002;   // verovatnoca hitnog kocenja u voznji
+    unsigned int seed = 12345;
+};
+
+struct StationSimStats {
+    long long guestsArrived = 0;
+    long long guestsRidden = 0;
+    long long rides = 0;
+    long long emergencies = 0;
+    long long eventsProcessed = 0;
+    double totalQueueWait = 0.0;
+    double maxQueueWait = 0.0;
+    int maxQueueLength = 0;
+    double simulatedTime = 0.0;
+    double rideRunTime = 0.0;
+};
+
+// runStationSimulation
+// Simulacija diskretnih dogadjaja: dolasci gostiju, ukrcavanje, vezivanje,
+// voznja i iskrcavanje su dogadjaji u redu sa prioritetom, pa se vreme
+// izmedju njih preskace umesto da se otkucava frejm po frejm.
+// Voznja se cita iz trajectory, a hitno kocenje iz predictEmergencyStop.
+// trajectory mora biti napravljena za isti train.
+StationSimStats runStationSimulation(const StationSimConfig& config,
+    float trackTotalLength,
+    const TrainLayout& train,
+    const RideTrajectory& trajectory);
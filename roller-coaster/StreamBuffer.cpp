@@ -0,0 +1,63 @@
+#include "StreamBuffer.h"
+
+#include <iostream>
+
+void StreamBuffer::init(size_t frameBytes, bool allowPersistent)
+{
+    frameSize = frameBytes;
+    glGenBuffers(1, &bufferId);
+    glBindBuffer(GL_ARRAY_BUFFER, bufferId);
+
+    if (allowPersistent && GLEW_ARB_buffer_storage) {
+        // koherentno mapiranje: upis je vidljiv GPU-u bez glFlushMappedBufferRange
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, STREAM_FRAMES * frameSize, NULL, flags);
+        mapped = static_cast<unsigned char*>(
+            glMapBufferRange(GL_ARRAY_BUFFER, 0, STREAM_FRAMES * frameSize, flags));
+    }
+
+    if (!mapped) {
+        if (allowPersistent) std::cout << "Trajno mapiranje nije dostupno, instance idu kroz glBufferSubData." << std::endl;
+        glBufferData(GL_ARRAY_BUFFER, frameSize, NULL, GL_STREAM_DRAW);
+        staging.resize(frameSize);
+    }
+}
+
+void* StreamBuffer::beginWrite()
+{
+    if (!mapped) return staging.data();
+
+    // deo je slobodan kad GPU zavrsi frejm od pre STREAM_FRAMES frejmova
+    GLsync& fence = fences[frame];
+    if (fence) {
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            ++stallCount;
+            do {
+                status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            } while (status == GL_TIMEOUT_EXPIRED);
+        }
+        glDeleteSync(fence);
+        fence = 0;
+    }
+    return mapped + frame * frameSize;
+}
+
+size_t StreamBuffer::endWrite(size_t bytesWritten)
+{
+    if (mapped) return frame * frameSize;
+
+    // ceo bafer se menja svaki frejm, pa se stari odbacuje umesto da se ceka GPU
+    glBindBuffer(GL_ARRAY_BUFFER, bufferId);
+    glBufferData(GL_ARRAY_BUFFER, frameSize, NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytesWritten, staging.data());
+    return 0;
+}
+
+void StreamBuffer::endFrame()
+{
+    if (!mapped) return;
+
+    fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame = (frame + 1) % STREAM_FRAMES;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <vector>
+
+// koliko frejmova moze istovremeno da koristi bafer
+const int STREAM_FRAMES = 3;
+
+// StreamBuffer
+// Bafer za podatke koji se menjaju svaki frejm (instance voza). Podeljen je
+// na STREAM_FRAMES delova, frejm pise u svoj deo, a fence posle poslednjeg
+// poziva koji ga cita javlja kad GPU vise ne koristi taj deo. Sa
+// ARB_buffer_storage bafer je trajno mapiran i upisuje se direktno, bez
+// glBufferSubData kopije i bez implicitne sinhronizacije u drajveru. Bez
+// njega se pise u niz na CPU i salje sa orphaning (glBufferData(NULL) +
+// glBufferSubData), pa je deo uvek prvi.
+class StreamBuffer {
+public:
+    // frameBytes je najvise bajtova po frejmu, allowPersistent = false
+    // uvek bira zamenski nacin
+    void init(size_t frameBytes, bool allowPersistent);
+
+    // na pocetku upisa: ceka da GPU pusti deo ovog frejma i vraca pokazivac
+    // za upis najvise frameBytes bajtova
+    void* beginWrite();
+
+    // posle upisa, pre crtanja; vraca pomeraj dela u baferu u bajtovima
+    size_t endWrite(size_t bytesWritten);
+
+    // posle poslednjeg poziva koji cita deo ovog frejma
+    void endFrame();
+
+    GLuint buffer() const { return bufferId; }
+    bool persistent() const { return mapped != nullptr; }
+
+    // koliko puta je beginWrite morao da ceka GPU
+    int stalls() const { return stallCount; }
+
+private:
+    GLuint bufferId = 0;
+    size_t frameSize = 0;
+    unsigned char* mapped = nullptr;  // ceo bafer, samo trajno mapiran
+    std::vector<unsigned char> staging; // zamenski nacin
+    GLsync fences[STREAM_FRAMES] = {};
+    int frame = 0;
+    int stallCount = 0;
+};
@@ -0,0 +1,131 @@
+#include "TimerWheel.h"
+
+#include <cmath>
+
+TimerWheel::TimerWheel(double tickSeconds)
+    : tick(tickSeconds)
+{
+    for (int i = 0; i < LEVELS * SLOTS; ++i) heads[i] = -1;
+}
+
+int TimerWheel::schedule(double delaySeconds, int owner, int kind)
+{
+    int id;
+    if (!freeNodes.empty()) {
+        id = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else {
+        id = static_cast<int>(nodes.size());
+        nodes.push_back(Node());
+    }
+
+    uint64_t delayTicks = delaySeconds > 0.0
+        ? static_cast<uint64_t>(std::ceil(delaySeconds / tick))
+        : 0;
+
+    Node& node = nodes[id];
+    node.expireTick = currentTick + delayTicks;
+    node.owner = owner;
+    node.kind = kind;
+    insert(id);
+
+    activeCount++;
+    return id;
+}
+
+void TimerWheel::cancel(int id)
+{
+    if (id < 0 || id >= static_cast<int>(nodes.size()) || nodes[id].slot < 0) return;
+
+    unlink(id);
+    freeNodes.push_back(id);
+    activeCount--;
+}
+
+// bira nivo prema tome koliko je daleko istek
+void TimerWheel::insert(int id)
+{
+    Node& node = nodes[id];
+    uint64_t expire = node.expireTick < currentTick ? currentTick : node.expireTick;
+    uint64_t delta = expire - currentTick;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    // predaleko u buducnosti, ostaje na vrhu do sledeceg prolaza
+    if (level == LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * LEVELS))) {
+        expire = currentTick + (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+    }
+
+    int index = static_cast<int>((expire >> (SLOT_BITS * level)) & (SLOTS - 1));
+    int slot = level * SLOTS + index;
+
+    node.slot = slot;
+    node.prev = -1;
+    node.next = heads[slot];
+    if (heads[slot] >= 0) nodes[heads[slot]].prev = id;
+    heads[slot] = id;
+}
+
+void TimerWheel::unlink(int id)
+{
+    Node& node = nodes[id];
+    if (node.prev >= 0) nodes[node.prev].next = node.next;
+    else heads[node.slot] = node.next;
+    if (node.next >= 0) nodes[node.next].prev = node.prev;
+    node.slot = -1;
+}
+
+// tajmeri iz trenutnog slota nivoa spustaju se na nize nivoe
+void TimerWheel::cascade(int level)
+{
+    int index = static_cast<int>((currentTick >> (SLOT_BITS * level)) & (SLOTS - 1));
+    int slot = level * SLOTS + index;
+
+    int id = heads[slot];
+    heads[slot] = -1;
+    while (id >= 0) {
+        int next = nodes[id].next;
+        insert(id);
+        id = next;
+    }
+}
+
+void TimerWheel::advance(double deltaTime, std::vector<TimerExpiry>& expired)
+{
+    accumulator += deltaTime;
+    uint64_t ticks = static_cast<uint64_t>(accumulator / tick);
+    accumulator -= ticks * tick;
+
+    // nema tajmera, nema ni sta da se obilazi
+    if (activeCount == 0) {
+        currentTick += ticks;
+        return;
+    }
+
+    for (uint64_t t = 0; t < ticks; ++t) {
+        int index = static_cast<int>(currentTick & (SLOTS - 1));
+        if (index == 0) {
+            for (int level = 1; level < LEVELS; ++level) {
+                cascade(level);
+                if (((currentTick >> (SLOT_BITS * level)) & (SLOTS - 1)) != 0) break;
+            }
+        }
+
+        int id = heads[index];
+        heads[index] = -1;
+        while (id >= 0) {
+            Node& node = nodes[id];
+            int next = node.next;
+            expired.push_back({ node.owner, node.kind });
+            node.slot = -1;
+            freeNodes.push_back(id);
+            activeCount--;
+            id = next;
+        }
+
+        currentTick++;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+// rezolucija tajmera u sekundama
+const double TIMER_WHEEL_TICK = 0.001;
+
+struct TimerExpiry {
+    int owner; // npr. indeks voza
+    int kind;  // sta je isteklo, tumaci onaj ko je zakazao
+};
+
+// TimerWheel
+// Hijerarhijski tocak tajmera: 4 nivoa po 64 slota. Zakazivanje i
+// otkazivanje su O(1), a tajmer se dira tek kad istekne (ili kad se
+// jednom spusti na nizi nivo). Nivoi pokrivaju ~4.6h unapred, duzi tajmer
+// ostaje na vrhu i ponovo se rasporedjuje pri svakom prolazu, pa istice na vreme.
+//
+// Id vracen iz schedule vazi dok tajmer ne istekne ili se ne otkaze,
+// posle toga ga onaj ko ga cuva treba da zaboravi.
+class TimerWheel {
+public:
+    explicit TimerWheel(double tickSeconds = TIMER_WHEEL_TICK);
+
+    int  schedule(double delaySeconds, int owner, int kind);
+    void cancel(int id);
+
+    // pomera vreme za deltaTime i dodaje istekle tajmere u expired
+    void advance(double deltaTime, std::vector<TimerExpiry>& expired);
+
+    int pendingCount() const { return activeCount; }
+    // redni broj sledeceg tika koji advance obradjuje
+    uint64_t now() const { return currentTick; }
+
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+
+    struct Node {
+        uint64_t expireTick;
+        int owner;
+        int kind;
+        int prev;
+        int next;
+        int slot; // level * SLOTS + index, -1 ako je cvor slobodan
+    };
+
+    void insert(int id);
+    void unlink(int id);
+    void cascade(int level);
+
+    double tick;
+    double accumulator = 0.0;
+    uint64_t currentTick = 0;
+    int activeCount = 0;
+
+    std::vector<Node> nodes;
+    std::vector<int>  freeNodes;
+    int heads[LEVELS * SLOTS];
+};
@@ -0,0 +1,46 @@
+#include "TrackRenderer.h"
+#include "Util.h"
+#include "UniformBlocks.h"
+#include "PackedVertex.h"
+#include "TrackTextures.h"
+
+#include <iostream>
+
+void TrackRenderer::init(GLuint positions, int pointCount, const char* vertPath, const char* fragPath)
+{
+    this->pointCount = pointCount;
+
+    glGenVertexArrays(1, &lineVAO);
+    glBindVertexArray(lineVAO);
+    setTrackPositionAttributes(positions);
+    glGenVertexArrays(1, &segmentVAO);
+    glBindVertexArray(0);
+
+    GLuint shader = createShader(vertPath, fragPath);
+    GLint linked = GL_FALSE;
+    glGetProgramiv(shader, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        std::cout << "Sejder staze nije preveden, staza se crta kao linija." << std::endl;
+        glDeleteProgram(shader);
+        return;
+    }
+    bindUniformBlocks(shader);
+    setTrackSamplers(shader);
+
+    program = shader;
+}
+
+void TrackRenderer::draw(GlStateCache& gl, GLuint lineProgram)
+{
+    if (!thick()) {
+        gl.useProgram(lineProgram);
+        gl.bindVertexArray(lineVAO);
+        glDrawArrays(GL_LINE_STRIP, 0, pointCount);
+        return;
+    }
+    if (pointCount < 2) return;
+
+    gl.useProgram(program);
+    gl.bindVertexArray(segmentVAO);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, pointCount - 1);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <GL/glew.h>
+
+#include "GlState.h"
+
+// TrackRenderer
+// Staza kao debela linija sa glatkim ivicama, bez triangulacije na CPU.
+// Polozaji staze se citaju iz bafer teksture (TrackTextures), a svaki
+// segment je jedna instanca od 4 temena koju vertex sejder razvlaci u
+// pravougaonik na ekranu. Fragment sejder racuna rastojanje do segmenta u
+// pikselima, pa debljina ne zavisi od drajvera. Ako program ne prodje,
+// crta se GL_LINE_STRIP kao ranije.
+class TrackRenderer {
+public:
+    // positions sadrzi pointCount TrackPosition, iz njega se crta linija
+    void init(GLuint positions, int pointCount, const char* vertPath, const char* fragPath);
+
+    // Pass blok staze i TrackTextures moraju vec biti vezani,
+    // lineProgram je za GL_LINE_STRIP
+    void draw(GlStateCache& gl, GLuint lineProgram);
+
+    bool thick() const { return program != 0; }
+
+private:
+    GLuint program = 0;         // 0 -> linija
+    GLuint segmentVAO = 0;      // bez nizova, temena su iz gl_VertexID
+    GLuint lineVAO = 0;
+    int pointCount = 0;
+};
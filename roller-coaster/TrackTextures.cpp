@@ -0,0 +1,46 @@
+#include "TrackTextures.h"
+
+#include <iostream>
+
+bool createTrackTextures(GLuint positionBuffer, const std::vector<float>& trackS, TrackTextures& textures)
+{
+    textures.pointCount = static_cast<int>(trackS.size());
+
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    if (textures.pointCount > maxTexels) {
+        std::cout << "Staza ima " << textures.pointCount << " tacaka, bafer tekstura najvise "
+            << maxTexels << "." << std::endl;
+        return false;
+    }
+
+    glGenBuffers(1, &textures.lengthBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, textures.lengthBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, trackS.size() * sizeof(float), trackS.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    glGenTextures(1, &textures.positions);
+    glBindTexture(GL_TEXTURE_BUFFER, textures.positions);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG16I, positionBuffer);
+
+    glGenTextures(1, &textures.lengths);
+    glBindTexture(GL_TEXTURE_BUFFER, textures.lengths);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, textures.lengthBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    return true;
+}
+
+void bindTrackTextures(GlStateCache& gl, const TrackTextures& textures)
+{
+    gl.bindTexture(TRACK_POSITIONS_UNIT, GL_TEXTURE_BUFFER, textures.positions);
+    gl.bindTexture(TRACK_LENGTHS_UNIT, GL_TEXTURE_BUFFER, textures.lengths);
+}
+
+void setTrackSamplers(GLuint program)
+{
+    glUseProgram(program);
+    GLint positions = glGetUniformLocation(program, "uTrackPositions");
+    if (positions >= 0) glUniform1i(positions, TRACK_POSITIONS_UNIT);
+    GLint lengths = glGetUniformLocation(program, "uTrackS");
+    if (lengths >= 0) glUniform1i(lengths, TRACK_LENGTHS_UNIT);
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <GL/glew.h>
+
+#include "GlState.h"
+
+#include <vector>
+
+// jedinice tekstura za stazu, posle uTex i uSprites
+const int TRACK_POSITIONS_UNIT = 2;
+const int TRACK_LENGTHS_UNIT = 3;
+
+// TrackTextures
+// Staza za sejdere, upisana jednom: polozaji tacaka (TrackPosition kao
+// GL_RG16I, isti bafer iz kog se crta linija) i trackS (GL_R32F) kao bafer
+// teksture. Track sejder iz polozaja crta segmente, a basic i pick sejder
+// iz oba nalaze tacku pod svakim vagonom.
+struct TrackTextures {
+    GLuint positions = 0;
+    GLuint lengths = 0;
+    GLuint lengthBuffer = 0;
+    int pointCount = 0;
+};
+
+// false ako staza ima vise tacaka nego sto bafer tekstura moze da primi
+bool createTrackTextures(GLuint positionBuffer, const std::vector<float>& trackS, TrackTextures& textures);
+
+// vezuje obe teksture na TRACK_POSITIONS_UNIT i TRACK_LENGTHS_UNIT
+void bindTrackTextures(GlStateCache& gl, const TrackTextures& textures);
+
+// postavlja uTrackPositions i uTrackS programa na njihove jedinice
+void setTrackSamplers(GLuint program);
@@ -0,0 +1,57 @@
+#include "Train.h"
+
+template <int N>
+void updateTrainOffsets(
+    const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>&, // Train<N> ne prati deonice
+    Train<N>& train
+)
+{
+    const RideState& ride = train.ride;
+    const int lastSegment = static_cast<int>(trackS.size()) - 2;
+    const float spacing = ride.train.spacing;
+
+    // vagoni su poredjani unazad od glave, pa segment samo opada
+    int segment = ride.cursor.segment;
+    for (int i = 0; i < N; ++i) {
+        float s = ride.sHead - i * spacing;
+        if (s < 0.0f) s = 0.0f;
+        if (s > trackTotalLength) s = trackTotalLength;
+
+        while (segment < lastSegment && trackS[segment + 1] < s) ++segment;
+        while (segment > 0 && trackS[segment] > s) --segment;
+
+        float segLen = trackS[segment + 1] - trackS[segment];
+        float tLocal = (segLen > 0.0f) ? (s - trackS[segment]) / segLen : 0.0f;
+
+        const Vertex& v0 = vertices[segment];
+        const Vertex& v1 = vertices[segment + 1];
+        train.offsetX[i] = v0.x + tLocal * (v1.x - v0.x);
+        train.offsetY[i] = v0.y + tLocal * (v1.y - v0.y);
+    }
+}
+
+void updateTrainOffsets(
+    const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>& trackRuns,
+    DynamicTrain& train
+)
+{
+    updateSegmentOffsets(train.ride, trackS, trackTotalLength, vertices, trackRuns, train.offsetX, train.offsetY);
+}
+
+// duzine iz visitTrain
+template void updateTrainOffsets<4>(const std::vector<float>&, float,
+    const std::vector<Vertex>&, const std::vector<TrackRun>&, Train<4>&);
+template void updateTrainOffsets<8>(const std::vector<float>&, float,
+    const std::vector<Vertex>&, const std::vector<TrackRun>&, Train<8>&);
+template void updateTrainOffsets<16>(const std::vector<float>&, float,
+    const std::vector<Vertex>&, const std::vector<TrackRun>&, Train<16>&);
+template void updateTrainOffsets<32>(const std::vector<float>&, float,
+    const std::vector<Vertex>&, const std::vector<TrackRun>&, Train<32>&);
+template void updateTrainOffsets<64>(const std::vector<float>&, float,
+    const std::vector<Vertex>&, const std::vector<TrackRun>&, Train<64>&);
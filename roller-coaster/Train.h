@@ -0,0 +1,87 @@
+#pragma once
+#include "Ride.h"
+
+#include <array>
+#include <vector>
+
+// Train<N>
+// Voz sa brojem vagona poznatim pri prevodjenju: stanje voznje i offseti
+// vagona. Offseti su std::array, a maske putnika u ride su jedna rec u
+// samoj SeatMask (N <= SEAT_MASK_INLINE_SEATS), pa voz nema nista na
+// heap-u. Petlja po vagonima ima konstantan broj prolaza pa je kompajler
+// moze razmotati. Prevedeni su samo za duzine iz visitTrain, ostale
+// duzine idu kroz DynamicTrain.
+template <int N>
+struct Train {
+    static_assert(N > 0, "voz mora imati bar jedan vagon");
+    static_assert(N <= SEAT_MASK_INLINE_SEATS, "maske putnika Train<N> moraju biti bez alokacije");
+
+    explicit Train(const TrainLayout& layout) : ride(layout), offsetX(), offsetY() {}
+
+    int carCount() const { return N; }
+
+    RideState ride;
+    std::array<float, N> offsetX;
+    std::array<float, N> offsetY;
+};
+
+// DynamicTrain
+// Isto za bilo koju duzinu voza, sa vektorima.
+struct DynamicTrain {
+    explicit DynamicTrain(const TrainLayout& layout)
+        : ride(layout), offsetX(layout.carCount, 0.0f), offsetY(layout.carCount, 0.0f) {}
+
+    int carCount() const { return static_cast<int>(offsetX.size()); }
+
+    RideState ride;
+    std::vector<float> offsetX;
+    std::vector<float> offsetY;
+};
+
+// updateTrainOffsets
+// Tacka na stazi ispod svakog vagona za train.ride, kao updateSegmentOffsets.
+// Train<N> hoda unazad od ride.cursor samo po segmentima staze, bez
+// trackRuns, a DynamicTrain poziva updateSegmentOffsets.
+template <int N>
+void updateTrainOffsets(
+    const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>& trackRuns,
+    Train<N>& train
+);
+
+void updateTrainOffsets(
+    const std::vector<float>& trackS,
+    float trackTotalLength,
+    const std::vector<Vertex>& vertices,
+    const std::vector<TrackRun>& trackRuns,
+    DynamicTrain& train
+);
+
+extern template void updateTrainOffsets<4>(const std::vector<float>&, float,
+    const std::vector<Vertex>&, const std::vector<TrackRun>&, Train<4>&);
+extern template void updateTrainOffsets<8>(const std::vector<float>&, float,
+    const std::vector<Vertex>&, const std::vector<TrackRun>&, Train<8>&);
+extern template void updateTrainOffsets<16>(const std::vector<float>&, float,
+    const std::vector<Vertex>&, const std::vector<TrackRun>&, Train<16>&);
+extern template void updateTrainOffsets<32>(const std::vector<float>&, float,
+    const std::vector<Vertex>&, const std::vector<TrackRun>&, Train<32>&);
+extern template void updateTrainOffsets<64>(const std::vector<float>&, float,
+    const std::vector<Vertex>&, const std::vector<TrackRun>&, Train<64>&);
+
+// visitTrain
+// Pravi Train<N> ako je layout.carCount jedna od prevedenih duzina, inace
+// DynamicTrain, i predaje ga visit. visit je genericka lambda (auto& train).
+template <typename Visitor>
+void visitTrain(const TrainLayout& layout, Visitor&& visit)
+{
+    switch (layout.carCount) {
+    case 4:  { Train<4> train(layout);  visit(train); break; }
+    case 8:  { Train<8> train(layout);  visit(train); break; }
+    case 16: { Train<16> train(layout); visit(train); break; }
+    case 32: { Train<32> train(layout); visit(train); break; }
+    case 64: { Train<64> train(layout); visit(train); break; }
+    default: { DynamicTrain train(layout); visit(train); break; }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+
+// TripleBuffer
+// Jedan pisac i jedan citalac razmenjuju cele snimke bez zakljucavanja.
+// Pisac uvek ima svoj slot, citalac svoj, a treci se razmenjuje atomicnom
+// zamenom indeksa. Citalac uvek dobija najnoviji objavljen snimak, a
+// nijedna strana ne ceka drugu.
+template <typename T>
+class TripleBuffer {
+public:
+    explicit TripleBuffer(const T& initial)
+    {
+        for (T& slot : slots) slot = initial;
+    }
+
+    // pisac: slot koji sme slobodno da menja
+    T& writeBuffer() { return slots[backIndex]; }
+
+    // pisac: objavljuje writeBuffer i dobija novi slot za pisanje
+    void publish()
+    {
+        backIndex = middle.exchange(backIndex | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // citalac: preuzima najnoviji snimak, vraca false ako novog nema
+    bool update()
+    {
+        if ((middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0) return false;
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    // citalac: snimak koji se trenutno prikazuje
+    const T& readBuffer() const { return slots[frontIndex]; }
+
+private:
+    static const int INDEX_MASK = 3;
+    static const int FRESH_BIT = 4;
+
+    T slots[3];
+    int backIndex = 0;
+    alignas(64) std::atomic<int> middle{ 1 };
+    alignas(64) int frontIndex = 2;
+};
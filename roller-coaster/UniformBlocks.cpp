@@ -0,0 +1,44 @@
+#include "UniformBlocks.h"
+
+#include <cstring>
+
+static size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void bindUniformBlocks(GLuint program)
+{
+    GLuint frameIndex = glGetUniformBlockIndex(program, "Frame");
+    if (frameIndex != GL_INVALID_INDEX) glUniformBlockBinding(program, frameIndex, FRAME_BLOCK_BINDING);
+    GLuint passIndex = glGetUniformBlockIndex(program, "Pass");
+    if (passIndex != GL_INVALID_INDEX) glUniformBlockBinding(program, passIndex, PASS_BLOCK_BINDING);
+}
+
+void UniformBlocks::init(bool allowPersistent)
+{
+    GLint alignment = 256;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    passOffset = alignUp(sizeof(FrameUniforms), alignment);
+    passStride = alignUp(sizeof(PassUniforms), alignment);
+    stream.init(passOffset + PASS_COUNT * passStride, allowPersistent);
+}
+
+void UniformBlocks::upload(GlStateCache& gl, const FrameUniforms& frame, const PassUniforms* passes)
+{
+    unsigned char* out = static_cast<unsigned char*>(stream.beginWrite());
+    std::memcpy(out, &frame, sizeof(FrameUniforms));
+    for (int pass = 0; pass < PASS_COUNT; ++pass) {
+        std::memcpy(out + passOffset + pass * passStride, &passes[pass], sizeof(PassUniforms));
+    }
+    frameBase = stream.endWrite(passOffset + PASS_COUNT * passStride);
+
+    gl.bindUniformRange(FRAME_BLOCK_BINDING, stream.buffer(), frameBase, sizeof(FrameUniforms));
+}
+
+void UniformBlocks::bindPass(GlStateCache& gl, int pass)
+{
+    gl.bindUniformRange(PASS_BLOCK_BINDING, stream.buffer(),
+        frameBase + passOffset + pass * passStride, sizeof(PassUniforms));
+}
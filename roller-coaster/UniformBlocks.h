@@ -0,0 +1,69 @@
+#pragma once
+#include <GL/glew.h>
+
+#include "GlState.h"
+#include "GpuPicker.h"
+#include "StreamBuffer.h"
+
+// tacke vezivanja blokova, iste za sve programe
+const GLuint FRAME_BLOCK_BINDING = 0;
+const GLuint PASS_BLOCK_BINDING = 1;
+
+// FrameUniforms
+// Blok Frame (std140), isti za ceo frejm i sve programe. Raspored mora da
+// se slaze sa deklaracijom u sejderima.
+struct FrameUniforms {
+    float viewProj[16];                 // mat4 po kolonama, za sada jedinicna
+    float spriteRects[SPRITE_LAYERS][4]; // (u0, v0, u1, v1) po sloju, za atlas
+    GLint useAtlas;
+    GLfloat positionScale;              // korak 16-bitnih polozaja, vidi PackedVertex.h
+    GLfloat viewport[2];                // velicina framebuffer-a u pikselima
+    GLfloat trainSHead;                 // jedina vrednost voza koja se menja po frejmu
+    GLfloat trainSpacing;
+    GLfloat trackLength;
+    GLint trackPoints;
+};
+
+// PassUniforms
+// Blok Pass (std140), jedan zapis po prolazu (PASS_*).
+struct PassUniforms {
+    GLfloat color[4]; // boja bez teksture (staza), umesto boje po verteksu
+    GLint useTexture;
+    GLfloat transparency;
+    GLuint idBits; // ID pass: PICK_PASSENGER_BIT za putnike, 0 za vagone
+    GLfloat lineWidth; // debljina staze u pikselima
+};
+
+// prolazi u baferu, redom
+const int PASS_TRACK = 0;
+const int PASS_TRAIN = 1;
+const int PASS_NAME = 2;
+const int PASS_PICK_CARS = 3;
+const int PASS_PICK_PASSENGERS = 4;
+const int PASS_COUNT = 5;
+
+// vezuje blokove Frame i Pass programa za FRAME_BLOCK_BINDING i PASS_BLOCK_BINDING
+void bindUniformBlocks(GLuint program);
+
+// UniformBlocks
+// Frame i svi Pass zapisi su u jednom delu StreamBuffer-a, pa se svaki
+// frejm upisuju jednim upisom. Poziv bira svoj prolaz sa glBindBufferRange,
+// pomeraji su poravnati na GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+class UniformBlocks {
+public:
+    void init(bool allowPersistent);
+
+    // jednom po frejmu, pre prvog crtanja; vezuje i Frame
+    void upload(GlStateCache& gl, const FrameUniforms& frame, const PassUniforms* passes);
+
+    void bindPass(GlStateCache& gl, int pass);
+
+    // posle poslednjeg crtanja u frejmu
+    void endFrame() { stream.endFrame(); }
+
+private:
+    StreamBuffer stream;
+    size_t passOffset = 0; // od pocetka dela frejma
+    size_t passStride = 0;
+    size_t frameBase = 0;  // pocetak dela ovog frejma u baferu
+};
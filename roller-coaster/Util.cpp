@@ -6,6 +6,8 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <algorithm>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -44,6 +46,8 @@ unsigned int compileShader(GLenum type, const char* source)
             printf("VERTEX");
         else if (type == GL_FRAGMENT_SHADER)
             printf("FRAGMENT");
+        else if (type == GL_COMPUTE_SHADER)
+            printf("COMPUTE");
         printf(" sejder ima gresku! Greska: \n");
         printf(infoLog);
     }
@@ -65,14 +69,15 @@ unsigned int createShader(const char* vsSource, const char* fsSource)
     glAttachShader(program, fragmentShader);
 
     glLinkProgram(program);
-    glValidateProgram(program);
 
+    // proverava se linkovanje, validacija bi zavisila od trenutnog stanja
+    // (sampleri razlicitih tipova su na istoj jedinici dok se ne podese)
     int success;
     char infoLog[512];
-    glGetProgramiv(program, GL_VALIDATE_STATUS, &success);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (success == GL_FALSE)
     {
-        glGetShaderInfoLog(program, 512, NULL, infoLog);
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
         std::cout << "Objedinjeni sejder ima gresku! Greska: \n";
         std::cout << infoLog << std::endl;
     }
@@ -85,6 +90,31 @@ unsigned int createShader(const char* vsSource, const char* fsSource)
     return program;
 }
 
+// compute sejder je sam u programu, GL 4.3
+unsigned int createComputeShader(const char* csSource)
+{
+    unsigned int program = glCreateProgram();
+    unsigned int computeShader = compileShader(GL_COMPUTE_SHADER, csSource);
+
+    glAttachShader(program, computeShader);
+    glLinkProgram(program);
+
+    int success;
+    char infoLog[512];
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (success == GL_FALSE)
+    {
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
+        std::cout << "Compute sejder ima gresku! Greska: \n";
+        std::cout << infoLog << std::endl;
+    }
+
+    glDetachShader(program, computeShader);
+    glDeleteShader(computeShader);
+
+    return program;
+}
+
 unsigned loadImageToTexture(const char* filePath) {
     int TextureWidth;
     int TextureHeight;
@@ -120,4 +150,99 @@ unsigned loadImageToTexture(const char* filePath) {
         stbi_image_free(ImageData);
         return 0;
     }
+}
+
+// usrednjava izvorne piksele koji padaju u svaki ciljni (box filter), boja je
+// tezinski po alfi da providni pikseli ne potamne ivice
+static void resampleRgba(const unsigned char* src, int srcWidth, int srcHeight,
+    unsigned char* dst, int dstWidth, int dstHeight)
+{
+    for (int y = 0; y < dstHeight; ++y) {
+        int sy0 = y * srcHeight / dstHeight;
+        int sy1 = std::max(sy0 + 1, (y + 1) * srcHeight / dstHeight);
+        for (int x = 0; x < dstWidth; ++x) {
+            int sx0 = x * srcWidth / dstWidth;
+            int sx1 = std::max(sx0 + 1, (x + 1) * srcWidth / dstWidth);
+
+            double rgb[3] = { 0.0, 0.0, 0.0 };
+            double alpha = 0.0;
+            int count = 0;
+            for (int sy = sy0; sy < sy1; ++sy) {
+                for (int sx = sx0; sx < sx1; ++sx) {
+                    const unsigned char* p = src + (sy * srcWidth + sx) * 4;
+                    for (int c = 0; c < 3; ++c) rgb[c] += p[c] * p[3];
+                    alpha += p[3];
+                    ++count;
+                }
+            }
+
+            unsigned char* out = dst + (y * dstWidth + x) * 4;
+            for (int c = 0; c < 3; ++c) {
+                out[c] = alpha > 0.0 ? static_cast<unsigned char>(rgb[c] / alpha + 0.5) : 0;
+            }
+            out[3] = static_cast<unsigned char>(alpha / count + 0.5);
+        }
+    }
+}
+
+unsigned loadImagesToTextureArray(const char* const* filePaths, int layerCount, bool* layerLoaded)
+{
+    // slojevi moraju biti iste velicine, uzima se velicina prve slike
+    int layerWidth = 0;
+    int layerHeight = 0;
+    std::vector<unsigned char> pixels;
+    std::vector<unsigned char> resized;
+
+    unsigned int Texture;
+    glGenTextures(1, &Texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, Texture);
+
+    for (int layer = 0; layer < layerCount; ++layer) {
+        int TextureWidth;
+        int TextureHeight;
+        int TextureChannels;
+        unsigned char* ImageData = stbi_load(filePaths[layer], &TextureWidth, &TextureHeight, &TextureChannels, 4);
+        layerLoaded[layer] = ImageData != NULL;
+        if (ImageData == NULL) {
+            std::cout << "Textura nije ucitana! Putanja texture: " << filePaths[layer] << std::endl;
+            continue;
+        }
+
+        stbi__vertical_flip(ImageData, TextureWidth, TextureHeight, 4);
+
+        if (layerWidth == 0) {
+            layerWidth = TextureWidth;
+            layerHeight = TextureHeight;
+            // nepopunjeni slojevi ostaju providni
+            pixels.assign(layerWidth * layerHeight * 4, 0);
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, layerWidth, layerHeight, layerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+            for (int i = 0; i < layerCount; ++i) {
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, layerWidth, layerHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            }
+        }
+
+        const unsigned char* layerData = ImageData;
+        if (TextureWidth != layerWidth || TextureHeight != layerHeight) {
+            resized.resize(layerWidth * layerHeight * 4);
+            resampleRgba(ImageData, TextureWidth, TextureHeight, resized.data(), layerWidth, layerHeight);
+            layerData = resized.data();
+        }
+
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, layerWidth, layerHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, layerData);
+        stbi_image_free(ImageData);
+    }
+
+    if (layerWidth == 0) {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glDeleteTextures(1, &Texture);
+        return 0;
+    }
+
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    return Texture;
 }
\ No newline at end of file
@@ -1,3 +1,8 @@
 #pragma once
 unsigned int createShader(const char* vsSource, const char* fsSource);
-unsigned loadImageToTexture(const char* filePath);
\ No newline at end of file
+unsigned int createComputeShader(const char* csSource);
+unsigned loadImageToTexture(const char* filePath);
+// ucitava slike kao slojeve GL_TEXTURE_2D_ARRAY, slike druge velicine se
+// preracunavaju na velicinu prve; layerLoaded[i] je false za sliku koja
+// nije ucitana, taj sloj ostaje providan
+unsigned loadImagesToTextureArray(const char* const* filePaths, int layerCount, bool* layerLoaded);
\ No newline at end of file
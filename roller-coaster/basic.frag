@@ -1,19 +1,41 @@
 #version 330 core
 
 in vec2 chTex;
-in vec4 chCol;
+flat in int chLayer;
 out vec4 outCol;
 
 
-uniform sampler2D uTex;
-uniform bool useTexture;
-uniform float uTransparency;
+uniform sampler2D uTex;          // ime, ili sve kad su sprajtovi u atlasu
+uniform sampler2DArray uSprites; // vagoni i putnici, sloj po instanci
+
+// isto kao FrameUniforms i PassUniforms u UniformBlocks.h
+layout(std140) uniform Frame {
+	mat4 uViewProj;
+	vec4 uSpriteRects[4]; // (u0, v0, u1, v1) po sloju, kad su sprajtovi u atlasu
+	int uUseAtlas;
+	float uPositionScale; // korak polozaja u verteksima
+	vec2 uViewport;
+	float uTrainSHead; // vagon i je na uTrainSHead - i * uTrainSpacing
+	float uTrainSpacing;
+	float uTrackLength;
+	int uTrackPoints;
+};
+layout(std140) uniform Pass {
+	vec4 uColor;
+	int uUseTexture;
+	float uTransparency;
+	uint uIdBits;
+	float uLineWidth;
+};
 void main()
 {
-	if (useTexture) {
-        vec4 texCol = texture(uTex, chTex);
+	if (uUseTexture != 0) {
+        // sloj je isti za ceo kvadrat, pa grananje ne kvari mipmape
+        vec4 texCol;
+        if (chLayer >= 0 && uUseAtlas == 0) texCol = texture(uSprites, vec3(chTex, float(chLayer)));
+        else texCol = texture(uTex, chTex);
         outCol = vec4(texCol.rgb, texCol.a * uTransparency);
     } else {
-        outCol = vec4(chCol.rgb, chCol.a * uTransparency);
+        outCol = vec4(uColor.rgb, uColor.a * uTransparency);
     }
 }
\ No newline at end of file
@@ -1,19 +1,68 @@
 #version 330 core
 
-layout(location = 0) in vec2 inPos;
-layout(location = 1) in vec2 inTex;
-layout(location = 2) in vec3 inCol;
+layout(location = 0) in vec2 inPos;   // GLshort, u koracima uPositionScale
+layout(location = 1) in vec2 inTex;   // normalizovan, staza ga nema
+layout(location = 4) in float inIndex; // po instanci, indeks vagona
+layout(location = 5) in float inLayer; // po instanci, -1 za ime (tekstura iz uTex)
+
+uniform isamplerBuffer uTrackPositions; // TrackTextures
+uniform samplerBuffer uTrackS;
 
 out vec2 chTex;
-out vec4 chCol;
+flat out int chLayer;
+
+// isto kao FrameUniforms i PassUniforms u UniformBlocks.h
+layout(std140) uniform Frame {
+	mat4 uViewProj;
+	vec4 uSpriteRects[4]; // (u0, v0, u1, v1) po sloju, kad su sprajtovi u atlasu
+	int uUseAtlas;
+	float uPositionScale; // korak polozaja u verteksima
+	vec2 uViewport;
+	float uTrainSHead; // vagon i je na uTrainSHead - i * uTrainSpacing
+	float uTrainSpacing;
+	float uTrackLength;
+	int uTrackPoints;
+};
+layout(std140) uniform Pass {
+	vec4 uColor;
+	int uUseTexture;
+	float uTransparency;
+	uint uIdBits;
+	float uLineWidth;
+};
+
+// tacka staze ispod vagona, kao updateSegmentOffsets na CPU: binarna
+// pretraga segmenta po trackS, pa linearno izmedju njegovih tacaka
+vec2 carOffset(int car)
+{
+	float s = clamp(uTrainSHead - float(car) * uTrainSpacing, 0.0, uTrackLength);
+
+	int lo = 0;
+	int hi = uTrackPoints - 2;
+	while (lo < hi) {
+		int mid = (lo + hi + 1) / 2;
+		if (texelFetch(uTrackS, mid).r <= s) lo = mid;
+		else hi = mid - 1;
+	}
 
-uniform vec2 uOffset;
+	float s0 = texelFetch(uTrackS, lo).r;
+	float segLen = texelFetch(uTrackS, lo + 1).r - s0;
+	float t = segLen > 0.0 ? (s - s0) / segLen : 0.0;
+	vec2 p0 = vec2(texelFetch(uTrackPositions, lo).xy);
+	vec2 p1 = vec2(texelFetch(uTrackPositions, lo + 1).xy);
+	return mix(p0, p1, t) * uPositionScale;
+}
 
 void main()
 {
-	vec2 pos = inPos + uOffset;
-	gl_Position = vec4(pos, 0.0, 1.0);
+	chLayer = int(inLayer);
+
+	// vagoni i putnici stoje na stazi, ime nema instance
+	vec2 pos = inPos * uPositionScale;
+	if (chLayer >= 0) pos += carOffset(int(inIndex));
+	gl_Position = uViewProj * vec4(pos, 0.0, 1.0);
 
-	chTex = inTex;
-	chCol = vec4(inCol, 1.0);
+	// kvadrat voza ima koordinate [0, 1], atlas ih smesta u pravougaonik sloja
+	if (uUseAtlas != 0 && chLayer >= 0) chTex = mix(uSpriteRects[chLayer].xy, uSpriteRects[chLayer].zw, inTex);
+	else chTex = inTex;
 }
\ No newline at end of file
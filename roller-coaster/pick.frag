@@ -0,0 +1,37 @@
+#version 330 core
+
+in vec2 chTex;
+flat in uint chId;
+flat in int chLayer;
+out uint outId;
+
+uniform sampler2DArray uSprites;
+uniform sampler2D uAtlas;
+
+// isto kao FrameUniforms i PassUniforms u UniformBlocks.h
+layout(std140) uniform Frame {
+	mat4 uViewProj;
+	vec4 uSpriteRects[4]; // (u0, v0, u1, v1) po sloju, kad su sprajtovi u atlasu
+	int uUseAtlas;
+	float uPositionScale; // korak polozaja u verteksima
+	vec2 uViewport;
+	float uTrainSHead; // vagon i je na uTrainSHead - i * uTrainSpacing
+	float uTrainSpacing;
+	float uTrackLength;
+	int uTrackPoints;
+};
+layout(std140) uniform Pass {
+	vec4 uColor;
+	int uUseTexture;
+	float uTransparency;
+	uint uIdBits;
+	float uLineWidth;
+};
+
+void main()
+{
+	// providni delovi sprajta ne zaklanjaju ono ispod
+	float alpha = uUseAtlas != 0 ? texture(uAtlas, chTex).a : texture(uSprites, vec3(chTex, float(chLayer))).a;
+	if (alpha < 0.5) discard;
+	outId = chId;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#version 330 core
+
+flat in vec2 chSegmentStart;
+flat in vec2 chSegmentEnd;
+out vec4 outCol;
+
+// isto kao FrameUniforms i PassUniforms u UniformBlocks.h
+layout(std140) uniform Frame {
+	mat4 uViewProj;
+	vec4 uSpriteRects[4]; // (u0, v0, u1, v1) po sloju, kad su sprajtovi u atlasu
+	int uUseAtlas;
+	float uPositionScale; // korak polozaja u verteksima
+	vec2 uViewport;
+	float uTrainSHead; // vagon i je na uTrainSHead - i * uTrainSpacing
+	float uTrainSpacing;
+	float uTrackLength;
+	int uTrackPoints;
+};
+layout(std140) uniform Pass {
+	vec4 uColor;
+	int uUseTexture;
+	float uTransparency;
+	uint uIdBits;
+	float uLineWidth;
+};
+
+void main()
+{
+	// rastojanje centra piksela do duzi, krajevi su zaobljeni pa se
+	// susedni segmenti spajaju bez rupa
+	vec2 segment = chSegmentEnd - chSegmentStart;
+	vec2 fromStart = gl_FragCoord.xy - chSegmentStart;
+	float t = clamp(dot(fromStart, segment) / max(dot(segment, segment), 1e-6), 0.0, 1.0);
+	float dist = length(fromStart - segment * t);
+
+	// pokrivenost piksela ivicom, prelaz sirok jedan piksel
+	float coverage = clamp(0.5 * uLineWidth + 0.5 - dist, 0.0, 1.0);
+	if (coverage <= 0.0) discard;
+	outCol = vec4(uColor.rgb, uColor.a * uTransparency * coverage);
+}
\ No newline at end of file
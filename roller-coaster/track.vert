@@ -0,0 +1,60 @@
+#version 330 core
+
+// segment i staze je instanca i: traka od 4 temena oko duzi (p[i], p[i+1]),
+// prosirena za pola debljine i piksel za AA, i na krajevima zbog spojeva
+
+uniform isamplerBuffer uTrackPositions; // TrackPosition (GLshort x, y) po tacki
+
+flat out vec2 chSegmentStart; // krajevi duzi u pikselima prozora
+flat out vec2 chSegmentEnd;
+
+// isto kao FrameUniforms i PassUniforms u UniformBlocks.h
+layout(std140) uniform Frame {
+	mat4 uViewProj;
+	vec4 uSpriteRects[4]; // (u0, v0, u1, v1) po sloju, kad su sprajtovi u atlasu
+	int uUseAtlas;
+	float uPositionScale; // korak polozaja u verteksima
+	vec2 uViewport;
+	float uTrainSHead; // vagon i je na uTrainSHead - i * uTrainSpacing
+	float uTrainSpacing;
+	float uTrackLength;
+	int uTrackPoints;
+};
+layout(std140) uniform Pass {
+	vec4 uColor;
+	int uUseTexture;
+	float uTransparency;
+	uint uIdBits;
+	float uLineWidth;
+};
+
+vec2 toPixels(vec4 clip)
+{
+	return (clip.xy / clip.w * 0.5 + 0.5) * uViewport;
+}
+
+void main()
+{
+	vec2 pos0 = vec2(texelFetch(uTrackPositions, gl_InstanceID).xy) * uPositionScale;
+	vec2 pos1 = vec2(texelFetch(uTrackPositions, gl_InstanceID + 1).xy) * uPositionScale;
+	vec4 clip0 = uViewProj * vec4(pos0, 0.0, 1.0);
+	vec4 clip1 = uViewProj * vec4(pos1, 0.0, 1.0);
+	vec2 p0 = toPixels(clip0);
+	vec2 p1 = toPixels(clip1);
+
+	vec2 along = p1 - p0;
+	float len = length(along);
+	vec2 dir = len > 0.0 ? along / len : vec2(1.0, 0.0);
+	vec2 normal = vec2(-dir.y, dir.x);
+
+	float extent = 0.5 * uLineWidth + 1.0;
+	bool atEnd = gl_VertexID >= 2;
+	float side = (gl_VertexID & 1) == 0 ? -1.0 : 1.0;
+	vec2 pixel = (atEnd ? p1 + dir * extent : p0 - dir * extent) + normal * side * extent;
+
+	chSegmentStart = p0;
+	chSegmentEnd = p1;
+
+	vec4 clip = atEnd ? clip1 : clip0;
+	gl_Position = vec4((pixel / uViewport * 2.0 - 1.0) * clip.w, clip.zw);
+}
\ No newline at end of file